@@ -9,6 +9,11 @@
       "sources": [
         "src/addon.cc",
         "src/mms_client.cc",
+        "src/connection_loop.cc",
+        "src/mms_value_converter.cc",
+        "src/event_keys.cc",
+        "src/event_queue.cc",
+        "src/report_journal.cc",
         "src/goose_subscriber.cc"
       ],      
       "include_dirs": [
@@ -205,7 +205,9 @@ const client = new MmsClient((event, data) => {
                     'simpleIOGenericIO/GGIO1.SPCSO3.stVal',
                     'simpleIOGenericIO/GGIO1.SPCSO4.stVal'
                 ];
-                dataRefs.forEach(ref => client.readData(ref));
+                dataRefs.forEach(ref => client.readData(ref)
+                    .then(value => console.log(`readData ${ref}:`, value))
+                    .catch(err => console.error(`readData ${ref} failed:`, err.message)));
 
                 // Включение отчётов
                 const rcbRef = 'simpleIOGenericIO/LLN0.RP.EventsRCB01';
@@ -35,7 +35,9 @@ const client = new MmsClient((event, data) => {
                     'WAGO61850ServerDevice/GGIO1.Ind.stVal',
                     'WAGO61850ServerDevice/CALH1.GrAlm.stVal'                    
                 ];
-                dataRefs.forEach(ref => client.readData(ref));               
+                dataRefs.forEach(ref => client.readData(ref)
+                    .then(value => console.log(`readData ${ref}:`, value))
+                    .catch(err => console.error(`readData ${ref} failed:`, err.message)));
 
                 // Включение отчётов
                 const rcbRef = 'WAGO61850ServerDevice/LLN0.RP.ReportBlock0101';
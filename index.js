@@ -30,4 +30,5 @@ if (!fs.existsSync(bindingPath)) {
 }
 
 const binding = require(bindingPath);
+binding.MmsPayload = require('./mms_payload').MmsPayload;
 module.exports = binding;
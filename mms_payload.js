@@ -0,0 +1,184 @@
+// Lazy reader for the `payload` ArrayBuffer of dataset reads and reports made with
+// `format: 'binary'`. Members are decoded only when they are accessed; get(i) returns the
+// same value the default 'objects' format delivers without `namedFields`, for the same
+// `timestampMode`, `timeQuality` and `qualityMode` options. The payload carries no component
+// names, so structures always use the positional keys field0..N and a `q` component is
+// rendered like any other bit string. The layout is described in src/mms_value_converter.h (BinaryMmsValues).
+
+const MMS_ARRAY = 0;
+const MMS_STRUCTURE = 1;
+const MMS_BOOLEAN = 2;
+const MMS_BIT_STRING = 3;
+const MMS_INTEGER = 4;
+const MMS_FLOAT = 6;
+const MMS_VISIBLE_STRING = 8;
+const MMS_UTC_TIME = 14;
+const MMS_DATA_ACCESS_ERROR = 15;
+const TAG_UNSUPPORTED = 0xff;
+const FLAG_REASONS = 1;
+
+const utf8 = new TextDecoder();
+
+function pad(value, length) {
+  return String(value).padStart(length, '0');
+}
+
+// Same text as the native formatting: "YYYY-MM-DD hh:mm:ss.<ms, not padded>"
+function formatUtcTime(ms) {
+  const date = new Date(ms);
+  return `${date.getUTCFullYear()}-${pad(date.getUTCMonth() + 1, 2)}-${pad(date.getUTCDate(), 2)} ` +
+    `${pad(date.getUTCHours(), 2)}:${pad(date.getUTCMinutes(), 2)}:${pad(date.getUTCSeconds(), 2)}.${ms % 1000}`;
+}
+
+const VALIDITIES = ['good', 'reserved', 'invalid', 'questionable'];
+
+function decodeQuality(bits) {
+  return {
+    bits,
+    validity: VALIDITIES[bits & 3],
+    source: (bits & 1024) ? 'substituted' : 'process',
+    test: (bits & 2048) !== 0,
+    operatorBlocked: (bits & 4096) !== 0
+  };
+}
+
+class MmsPayload {
+  constructor(buffer, options = {}) {
+    this.view = new DataView(buffer);
+    this.timestampMode = options.timestampMode || 'string';
+    this.timeQuality = options.timeQuality === true;
+    this.qualityMode = options.qualityMode || 'string';
+    this.length = this.view.getUint32(0, true);
+    const flags = this.view.getUint32(4, true);
+    this.reasonsOffset = 8 + (this.length + 1) * 4;
+    this.hasReasons = (flags & FLAG_REASONS) !== 0;
+    this.cache = new Map();
+  }
+
+  // Start of member i, or -1 if it is not present (not included in the report)
+  offset(i) {
+    if (i < 0 || i >= this.length) return -1;
+    const start = this.view.getUint32(8 + i * 4, true);
+    const end = this.view.getUint32(8 + (i + 1) * 4, true);
+    return end > start ? start : -1;
+  }
+
+  has(i) {
+    return this.offset(i) >= 0;
+  }
+
+  // Reason for inclusion of member i in a report, 0 for dataset reads
+  reason(i) {
+    return this.hasReasons ? this.view.getUint8(this.reasonsOffset + i) : 0;
+  }
+
+  // MmsType of member i without decoding it, or undefined
+  type(i) {
+    const offset = this.offset(i);
+    return offset < 0 ? undefined : this.view.getUint8(offset);
+  }
+
+  get(i) {
+    return this.decodeMember(i).value;
+  }
+
+  isValid(i) {
+    return this.decodeMember(i).valid;
+  }
+
+  // All members as the 'objects' format would deliver them; not included members are skipped
+  toArray() {
+    const values = [];
+    for (let i = 0; i < this.length; i++) {
+      if (this.has(i)) values.push(this.get(i));
+    }
+    return values;
+  }
+
+  decodeMember(i) {
+    let result = this.cache.get(i);
+    if (result === undefined) {
+      const offset = this.offset(i);
+      result = offset < 0 ? { value: undefined, valid: false } : this.decode({ pos: offset });
+      this.cache.set(i, result);
+    }
+    return result;
+  }
+
+  timestamp(ns, quality) {
+    if (this.timestampMode === 'string') return formatUtcTime(Number(ns / 1000000n));
+    const time = this.timestampMode === 'ns' ? ns : Number(ns / 1000000n);
+    return this.timeQuality ? { time, quality } : time;
+  }
+
+  bitString(size, bits) {
+    if (this.qualityMode === 'string') return `BitString(size=${size})`;
+    if (this.qualityMode === 'decoded' && size === 13) return decodeQuality(bits);
+    return bits;
+  }
+
+  decode(cursor) {
+    const view = this.view;
+    const tag = view.getUint8(cursor.pos++);
+    switch (tag) {
+      case MMS_STRUCTURE:
+      case MMS_ARRAY: {
+        const count = view.getUint32(cursor.pos, true);
+        cursor.pos += 4;
+        if (tag === MMS_ARRAY) {
+          const array = new Array(count);
+          for (let j = 0; j < count; j++) array[j] = this.decode(cursor).value;
+          return { value: array, valid: true };
+        }
+        // Invalid members are left out of structures
+        const struct = {};
+        let field = 0;
+        for (let j = 0; j < count; j++) {
+          const member = this.decode(cursor);
+          if (member.valid) struct['field' + field++] = member.value;
+        }
+        return { value: struct, valid: true };
+      }
+      case MMS_BOOLEAN:
+        return { value: view.getUint8(cursor.pos++) !== 0, valid: true };
+      case MMS_BIT_STRING: {
+        const size = view.getUint16(cursor.pos, true);
+        const bits = view.getUint32(cursor.pos + 2, true);
+        cursor.pos += 6;
+        return { value: this.bitString(size, bits), valid: true };
+      }
+      case MMS_INTEGER: {
+        const value = view.getInt32(cursor.pos, true);
+        cursor.pos += 4;
+        return { value, valid: true };
+      }
+      case MMS_FLOAT: {
+        const value = view.getFloat32(cursor.pos, true);
+        cursor.pos += 4;
+        if (!Number.isFinite(value)) return { value: 'Invalid float value', valid: false };
+        return { value, valid: true };
+      }
+      case MMS_VISIBLE_STRING: {
+        const length = view.getUint32(cursor.pos, true);
+        cursor.pos += 4;
+        const bytes = new Uint8Array(view.buffer, view.byteOffset + cursor.pos, length);
+        cursor.pos += length;
+        return { value: utf8.decode(bytes), valid: true };
+      }
+      case MMS_UTC_TIME: {
+        const ns = view.getBigUint64(cursor.pos, true);
+        const quality = view.getUint8(cursor.pos + 8);
+        cursor.pos += 9;
+        return { value: this.timestamp(ns, quality), valid: true };
+      }
+      case MMS_DATA_ACCESS_ERROR:
+        return { value: 'Data access error', valid: false };
+      case TAG_UNSUPPORTED:
+        return { value: `Unsupported type: ${view.getUint8(cursor.pos++)}`, valid: false };
+      default:
+        throw new Error(`Corrupt MMS payload: unknown tag ${tag}`);
+    }
+  }
+}
+
+module.exports = { MmsPayload };
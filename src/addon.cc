@@ -1,8 +1,10 @@
 #include <napi.h>
 #include "mms_client.h"
 #include "goose_subscriber.h"
+#include "event_keys.h"
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
+    EventKeys::Init(env);
     MmsClient::Init(env, exports);
     NodeGOOSESubscriber::Init(env, exports);
     return exports;
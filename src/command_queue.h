@@ -0,0 +1,202 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+// Unbounded multi-producer / single-consumer queue (Vyukov). Push is wait-free and may be
+// called from any thread; Pop must only be called from the single consumer thread.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head_.store(stub, std::memory_order_relaxed);
+        tail_ = stub;
+    }
+
+    ~MpscQueue() {
+        T discarded;
+        while (Pop(discarded)) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void Push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    bool Pop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) return false;
+        out = std::move(next->value);
+        tail_ = next;
+        delete tail;
+        return true;
+    }
+
+    // Consumer-side check; a push that is still being linked may briefly be reported as empty
+    bool Empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        Node() : next(nullptr) {}
+        explicit Node(T v) : next(nullptr), value(std::move(v)) {}
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
+
+// Command mailbox of a connection actor. Producers (the JS thread, libiec61850 callbacks) only
+// push; the owning I/O thread pops and sleeps in Wait() when there is nothing to do. The mutex
+// is only touched to park/unpark an idle consumer, never on the enqueue fast path.
+//
+// Commands are queued in priority lanes and Pop() always takes the oldest command of the most
+// urgent non-empty lane, so a control request overtakes queued polls and browsing. A command
+// that is already running is never interrupted.
+class CommandQueue {
+public:
+    using Command = std::function<void()>;
+
+    enum Lane {
+        LANE_INTERNAL,  // completions and connection housekeeping
+        LANE_CONTROL,
+        LANE_REPORTS,   // report and dataset configuration
+        LANE_POLLING,
+        LANE_BROWSE,
+        LANE_COUNT
+    };
+
+    struct LaneStats {
+        size_t depth;
+        uint64_t executed;
+        double avgWaitMs;
+        double maxWaitMs;
+    };
+
+    CommandQueue() : size_(0), sleeping_(false) {}
+
+    void Push(Command command, Lane lane = LANE_INTERNAL) {
+        LaneState& state = lanes_[lane];
+        state.size.fetch_add(1, std::memory_order_relaxed);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        state.queue.Push(Entry{std::move(command), std::chrono::steady_clock::now()});
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    bool Pop(Command& out) {
+        for (LaneState& state : lanes_) {
+            Entry entry;
+            if (!state.queue.Pop(entry)) continue;
+            state.size.fetch_sub(1, std::memory_order_relaxed);
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            uint64_t waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - entry.queuedAt).count();
+            state.executed.fetch_add(1, std::memory_order_relaxed);
+            state.totalWaitUs.fetch_add(waitUs, std::memory_order_relaxed);
+            if (waitUs > state.maxWaitUs.load(std::memory_order_relaxed)) {
+                state.maxWaitUs.store(waitUs, std::memory_order_relaxed);
+            }
+            out = std::move(entry.command);
+            return true;
+        }
+        return false;
+    }
+
+    // Blocks the consumer until a command is pushed, Notify() is called or the timeout expires
+    void Wait(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (Empty() && !notified_) {
+            cv_.wait_for(lock, timeout);
+        }
+        notified_ = false;
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // Wakes the consumer without queueing work (used for shutdown)
+    void Notify() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notified_ = true;
+        cv_.notify_one();
+    }
+
+    size_t Size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    // Queue depth and the time commands waited in the lane before running, since creation.
+    // Safe to call from any thread.
+    LaneStats Stats(Lane lane) const {
+        const LaneState& state = lanes_[lane];
+        LaneStats stats;
+        stats.depth = state.size.load(std::memory_order_relaxed);
+        stats.executed = state.executed.load(std::memory_order_relaxed);
+        uint64_t totalWaitUs = state.totalWaitUs.load(std::memory_order_relaxed);
+        stats.avgWaitMs = stats.executed ? double(totalWaitUs) / stats.executed / 1000.0 : 0.0;
+        stats.maxWaitMs = state.maxWaitUs.load(std::memory_order_relaxed) / 1000.0;
+        return stats;
+    }
+
+    static const char* LaneName(Lane lane) {
+        switch (lane) {
+            case LANE_INTERNAL: return "internal";
+            case LANE_CONTROL: return "control";
+            case LANE_REPORTS: return "reports";
+            case LANE_POLLING: return "polling";
+            case LANE_BROWSE: return "browse";
+            default: return "unknown";
+        }
+    }
+
+private:
+    struct Entry {
+        Command command;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    struct LaneState {
+        MpscQueue<Entry> queue;
+        std::atomic<size_t> size{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> totalWaitUs{0};
+        std::atomic<uint64_t> maxWaitUs{0};
+    };
+
+    bool Empty() const {
+        for (const LaneState& state : lanes_) {
+            if (!state.queue.Empty()) return false;
+        }
+        return true;
+    }
+
+    LaneState lanes_[LANE_COUNT];
+    std::atomic<size_t> size_;
+    std::atomic<bool> sleeping_;
+    bool notified_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+#endif  // COMMAND_QUEUE_H
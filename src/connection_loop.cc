@@ -0,0 +1,201 @@
+#include "connection_loop.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+constexpr std::chrono::milliseconds ConnectionLoop::TICK_IDLE_MAX;
+constexpr std::chrono::seconds ConnectionLoop::WORKER_IDLE_EXIT;
+
+// Positive integer from the environment, or fallback
+static size_t EnvSize(const char* name, size_t fallback) {
+    const char* value = getenv(name);
+    if (value == nullptr) {
+        return fallback;
+    }
+    long parsed = strtol(value, nullptr, 10);
+    return parsed > 0 ? static_cast<size_t>(parsed) : fallback;
+}
+
+ConnectionLoop& ConnectionLoop::Instance() {
+    // Never destroyed: the pool lives as long as the process
+    static ConnectionLoop* instance = [] {
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        size_t tickers = std::max<size_t>(1, cores / 4);
+        size_t workers = EnvSize("IEC61850_LOOP_WORKERS", std::max<size_t>(4, cores));
+        size_t maxWorkers = std::max(workers, EnvSize("IEC61850_LOOP_MAX_WORKERS", std::max<size_t>(128, workers)));
+        printf("ConnectionLoop: starting %zu ticker and %zu worker threads, up to %zu workers\n", tickers, workers, maxWorkers);
+        return new ConnectionLoop(tickers, workers, maxWorkers);
+    }();
+    return *instance;
+}
+
+ConnectionLoop::ConnectionLoop(size_t tickers, size_t workers, size_t maxWorkers)
+    : nextShard_(0), minWorkers_(workers), maxWorkers_(maxWorkers), workers_(workers), idleWorkers_(0) {
+    for (size_t i = 0; i < tickers; i++) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    for (auto& shard : shards_) {
+        shard->thread = std::thread(&ConnectionLoop::TickerLoop, this, shard.get());
+        shard->thread.detach();
+    }
+    for (size_t i = 0; i < workers; i++) {
+        std::thread(&ConnectionLoop::WorkerLoop, this).detach();
+    }
+}
+
+size_t ConnectionLoop::WorkerCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workers_;
+}
+
+void ConnectionLoop::Add(LoopClient* client, bool tick) {
+    size_t index = nextShard_.fetch_add(1) % shards_.size();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        client->shard_ = index;
+        client->detached_ = false;
+        client->ticked_ = tick;
+    }
+    if (!tick) {
+        return;
+    }
+    Shard* shard = shards_[index].get();
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->clients.push_back(client);
+    }
+    Wake(index);
+}
+
+void ConnectionLoop::Remove(LoopClient* client) {
+    size_t index;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        client->detached_ = true;
+        ready_.erase(std::remove(ready_.begin(), ready_.end(), client), ready_.end());
+        if (client->ticked_) {
+            idleCv_.wait(lock, [client] { return !client->inWorker_; });
+        } else {
+            // Its owner is the caller, which stopped ticking: nothing else reads the response
+            while (client->inWorker_) {
+                lock.unlock();
+                client->OnTick(std::chrono::steady_clock::now());
+                lock.lock();
+                idleCv_.wait_for(lock, std::chrono::milliseconds(1), [client] { return !client->inWorker_; });
+            }
+        }
+        client->scheduled_ = false;
+        index = client->shard_;
+    }
+    // Taking the shard lock waits for a tick round that may be using the client
+    Shard* shard = shards_[index].get();
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->clients.erase(std::remove(shard->clients.begin(), shard->clients.end(), client), shard->clients.end());
+}
+
+void ConnectionLoop::Schedule(LoopClient* client) {
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (client->detached_ || client->scheduled_) {
+            return;
+        }
+        client->scheduled_ = true;
+        index = client->shard_;
+        if (!client->inWorker_) {
+            ready_.push_back(client);
+            Dispatch();
+        }
+    }
+    // The command is about to send a request whose response only a tick can read
+    Wake(index);
+}
+
+void ConnectionLoop::Wake(size_t index) {
+    Shard* shard = shards_[index].get();
+    {
+        std::lock_guard<std::mutex> lock(shard->wakeMutex);
+        shard->woken = true;
+    }
+    shard->wakeCv.notify_one();
+}
+
+// Hands the queued client to an idle worker, or starts another one while the pool may grow
+void ConnectionLoop::Dispatch() {
+    readyCv_.notify_one();
+    // Idle workers that were notified but have not woken up yet still count as idle
+    if (ready_.size() > idleWorkers_ && workers_ < maxWorkers_) {
+        workers_++;
+        printf("ConnectionLoop: all workers busy, starting worker %zu\n", workers_);
+        std::thread(&ConnectionLoop::WorkerLoop, this).detach();
+    }
+}
+
+void ConnectionLoop::TickerLoop(Shard* shard) {
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        auto next = now + TICK_IDLE_MAX;
+        bool idle = true;
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (LoopClient* client : shard->clients) {
+                if (!client->OnTick(now)) {
+                    idle = false;
+                }
+                if (client->HasCommands()) {
+                    Schedule(client);
+                }
+                if (client->inWorker_) {
+                    // A blocking request is waiting for its response
+                    next = std::min(next, now + std::chrono::milliseconds(1));
+                } else {
+                    next = std::min(next, client->NextTick(now));
+                }
+            }
+        }
+        if (!idle) {
+            // More to read right away, but not ahead of the workers and the Add/Remove callers
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(shard->wakeMutex);
+        shard->wakeCv.wait_until(lock, next, [shard] { return shard->woken; });
+        shard->woken = false;
+    }
+}
+
+void ConnectionLoop::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        idleWorkers_++;
+        bool ready = readyCv_.wait_for(lock, WORKER_IDLE_EXIT, [this] { return !ready_.empty(); });
+        idleWorkers_--;
+        if (!ready) {
+            if (workers_ > minWorkers_) {
+                // Started for a backlog that is gone
+                workers_--;
+                return;
+            }
+            continue;
+        }
+        LoopClient* client = ready_.front();
+        ready_.pop_front();
+        client->scheduled_ = false;
+        client->inWorker_ = true;
+        lock.unlock();
+
+        // One command per turn: a client whose IED does not answer only delays its own queue
+        client->RunCommand();
+
+        lock.lock();
+        client->inWorker_ = false;
+        // Requeued behind the other clients; this worker is free again and takes the queue head
+        if (client->scheduled_ && !client->detached_) {
+            ready_.push_back(client);
+        } else if (!client->detached_ && client->HasCommands()) {
+            client->scheduled_ = true;
+            ready_.push_back(client);
+        }
+        idleCv_.notify_all();
+    }
+}
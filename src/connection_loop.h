@@ -0,0 +1,101 @@
+#ifndef CONNECTION_LOOP_H
+#define CONNECTION_LOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A connection driven by the shared ConnectionLoop instead of threads of its own
+class LoopClient {
+public:
+    virtual ~LoopClient() = default;
+
+    // Ticker thread: IedConnection_tick plus time-based housekeeping. Returns true when idle.
+    virtual bool OnTick(std::chrono::steady_clock::time_point now) = 0;
+    // Ticker thread, after an idle tick: when the connection has to be ticked again at the latest
+    virtual std::chrono::steady_clock::time_point NextTick(std::chrono::steady_clock::time_point now) = 0;
+    // Worker thread: pops and runs one queued command, never concurrently for the same client.
+    // Returns false when there was nothing to run.
+    virtual bool RunCommand() = 0;
+    virtual bool HasCommands() = 0;
+
+    // A command is running: it may be waiting for a response that only a tick reads
+    bool InWorker() const { return inWorker_; }
+
+private:
+    friend class ConnectionLoop;
+    // Guarded by ConnectionLoop::mutex_; inWorker_ is also read by the tickers without it
+    bool scheduled_ = false;
+    std::atomic<bool> inWorker_{false};
+    bool detached_ = false;
+    bool ticked_ = false;  // by a ticker thread, not by its owner
+    size_t shard_ = 0;
+};
+
+// Process-wide pool for non-threaded IedConnections. Ticker threads call IedConnection_tick
+// for their share of the connections; worker threads run the command actors, so blocking
+// requests on one connection are answered by another thread's tick.
+//
+// A worker runs one command of a client per turn and a client is never on two workers, so an
+// unresponsive IED holds at most one worker for at most one request timeout. When every worker
+// is busy and clients are waiting, the pool grows up to its maximum; the extra workers exit
+// again after WORKER_IDLE_EXIT without work. The sizes come from the environment variables
+// IEC61850_LOOP_WORKERS (default max(4, cores)) and IEC61850_LOOP_MAX_WORKERS (default
+// max(128, workers)), read when the first threadless client starts.
+class ConnectionLoop {
+public:
+    static ConnectionLoop& Instance();
+
+    // tick=false: the owner ticks the connection itself and only uses the worker pool
+    void Add(LoopClient* client, bool tick = true);
+    // Blocks until the client is neither ticked nor running on a worker. A client its owner ticks
+    // is ticked by the caller meanwhile, so the command on the worker can still get its response.
+    void Remove(LoopClient* client);
+    // Queues the client for a worker if it is not queued or running already
+    void Schedule(LoopClient* client);
+
+    size_t TickerCount() const { return shards_.size(); }
+    size_t WorkerCount();
+
+    // Idle tickers sleep until the earliest NextTick of their clients, at most TICK_IDLE_MAX
+    static constexpr std::chrono::milliseconds TICK_IDLE_MAX{10};
+    static constexpr std::chrono::seconds WORKER_IDLE_EXIT{30};
+
+private:
+    ConnectionLoop(size_t tickers, size_t workers, size_t maxWorkers);
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<LoopClient*> clients;
+        std::thread thread;
+        // Wakes the ticker before its deadline when one of its clients got work
+        std::mutex wakeMutex;
+        std::condition_variable wakeCv;
+        bool woken = false;
+    };
+
+    void TickerLoop(Shard* shard);
+    void WorkerLoop();
+    void Wake(size_t shard);
+    // Called with mutex_ held after a client was queued
+    void Dispatch();
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<size_t> nextShard_;
+
+    std::mutex mutex_;
+    std::condition_variable readyCv_;
+    std::condition_variable idleCv_;
+    std::deque<LoopClient*> ready_;
+    size_t minWorkers_;
+    size_t maxWorkers_;
+    size_t workers_;      // guarded by mutex_
+    size_t idleWorkers_;  // guarded by mutex_
+};
+
+#endif  // CONNECTION_LOOP_H
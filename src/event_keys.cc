@@ -0,0 +1,89 @@
+#include "event_keys.h"
+#include <cstdio>
+
+static const char* const KEY_NAMES[KEY_COUNT] = {
+    "clientID",
+    "type",
+    "event",
+    "reason",
+    "name",
+    "dataRef",
+    "datasetRef",
+    "rcbRef",
+    "rptId",
+    "value",
+    "values",
+    "isValid",
+    "timestamp",
+    "reasonsForInclusion",
+    "columns",
+    "payload",
+    "results",
+    "goCbRef",
+    "stNum",
+    "sqNum",
+    "confRev",
+    "time",
+    "quality",
+    "bits",
+    "validity",
+    "source",
+    "test",
+    "operatorBlocked",
+    "entries",
+    "index",
+    "ref",
+    "data",
+    "error",
+    "control",
+    "conn",
+    "dataSet",
+    "report",
+    "reports",
+    "readMany",
+    "goose"
+};
+
+void EventKeys::Init(Napi::Env env) {
+    EventKeys* keys = new EventKeys();
+    for (int i = 0; i < KEY_COUNT; i++) {
+        keys->keys_[i] = Napi::Reference<Napi::String>::New(Napi::String::New(env, KEY_NAMES[i]), 1);
+    }
+    char name[24];
+    for (uint32_t i = 0; i < FIELD_KEY_COUNT; i++) {
+        snprintf(name, sizeof(name), "field%u", i);
+        keys->fields_[i] = Napi::Reference<Napi::String>::New(Napi::String::New(env, name), 1);
+    }
+    env.SetInstanceData(keys);
+}
+
+const char* EventKeys::Text(EventKey key) {
+    return KEY_NAMES[key];
+}
+
+Napi::String EventKeys::Get(Napi::Env env, EventKey key) {
+    return env.GetInstanceData<EventKeys>()->keys_[key].Value();
+}
+
+Napi::String EventKeys::Field(Napi::Env env, uint32_t index) {
+    if (index < FIELD_KEY_COUNT) {
+        return env.GetInstanceData<EventKeys>()->fields_[index].Value();
+    }
+    char name[24];
+    snprintf(name, sizeof(name), "field%u", index);
+    return Napi::String::New(env, name);
+}
+
+Napi::String EventKeys::Name(Napi::Env env, const std::string& name) {
+    EventKeys* keys = env.GetInstanceData<EventKeys>();
+    auto it = keys->names_.find(name);
+    if (it != keys->names_.end()) {
+        return it->second.Value();
+    }
+    Napi::String key = Napi::String::New(env, name);
+    // The names come from whatever servers the process talks to: keep the persistent set bounded
+    if (keys->names_.size() < NAME_KEY_COUNT) {
+        keys->names_.emplace(name, Napi::Reference<Napi::String>::New(key, 1));
+    }
+    return key;
+}
@@ -0,0 +1,82 @@
+#ifndef EVENT_KEYS_H
+#define EVENT_KEYS_H
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Property names and fixed values of the emitted event objects
+enum EventKey : uint8_t {
+    KEY_CLIENT_ID,
+    KEY_TYPE,
+    KEY_EVENT,
+    KEY_REASON,
+    KEY_NAME,
+    KEY_DATA_REF,
+    KEY_DATASET_REF,
+    KEY_RCB_REF,
+    KEY_RPT_ID,
+    KEY_VALUE,
+    KEY_VALUES,
+    KEY_IS_VALID,
+    KEY_TIMESTAMP,
+    KEY_REASONS_FOR_INCLUSION,
+    KEY_COLUMNS,
+    KEY_PAYLOAD,
+    KEY_RESULTS,
+    KEY_GO_CB_REF,
+    KEY_ST_NUM,
+    KEY_SQ_NUM,
+    KEY_CONF_REV,
+    KEY_TIME,
+    KEY_QUALITY,
+    KEY_BITS,
+    KEY_VALIDITY,
+    KEY_SOURCE,
+    KEY_TEST,
+    KEY_OPERATOR_BLOCKED,
+    KEY_ENTRIES,
+    KEY_INDEX,
+    KEY_REF,
+    // values
+    KEY_DATA,
+    KEY_ERROR,
+    KEY_CONTROL,
+    KEY_CONN,
+    KEY_DATASET,
+    KEY_REPORT,
+    KEY_REPORTS,
+    KEY_READ_MANY,
+    KEY_GOOSE,
+    KEY_COUNT
+};
+
+// Strings of the event objects, created once per environment and kept as persistent references,
+// so building an event no longer creates (and V8 no longer internalizes) a fresh string for every
+// property name. Registered as the instance data of the environment by Init().
+class EventKeys {
+public:
+    static void Init(Napi::Env env);
+
+    // The text of a key, for events serialized natively (any thread)
+    static const char* Text(EventKey key);
+
+    // JS thread only
+    static Napi::String Get(Napi::Env env, EventKey key);
+    // "field<index>", cached for the first FIELD_KEY_COUNT indexes
+    static Napi::String Field(Napi::Env env, uint32_t index);
+    // A name from a server's data model (component name, data set member), cached on first use
+    // for the first NAME_KEY_COUNT distinct names; later ones are created on every call
+    static Napi::String Name(Napi::Env env, const std::string& name);
+
+private:
+    static const uint32_t FIELD_KEY_COUNT = 64;
+    static const size_t NAME_KEY_COUNT = 4096;
+
+    Napi::Reference<Napi::String> keys_[KEY_COUNT];
+    Napi::Reference<Napi::String> fields_[FIELD_KEY_COUNT];
+    std::unordered_map<std::string, Napi::Reference<Napi::String>> names_;
+};
+
+#endif  // EVENT_KEYS_H
@@ -0,0 +1,55 @@
+#include "event_queue.h"
+
+bool EventQueueOptions::Parse(Napi::Env env, Napi::Object options, EventQueueOptions& out) {
+    if (!options.Has("eventQueue") || !options.Get("eventQueue").IsObject()) {
+        return true;
+    }
+    Napi::Object queue = options.Get("eventQueue").As<Napi::Object>();
+    out.capacity = 10000;
+    if (queue.Has("capacity") && queue.Get("capacity").IsNumber()) {
+        int64_t capacity = queue.Get("capacity").As<Napi::Number>().Int64Value();
+        if (capacity < 1) {
+            Napi::TypeError::New(env, "eventQueue.capacity must be at least 1").ThrowAsJavaScriptException();
+            return false;
+        }
+        out.capacity = static_cast<size_t>(capacity);
+    }
+    if (queue.Has("policy") && queue.Get("policy").IsString()) {
+        std::string policy = queue.Get("policy").As<Napi::String>().Utf8Value();
+        if (policy == "block") {
+            out.policy = EventQueuePolicy::Block;
+        } else if (policy == "dropOldest") {
+            out.policy = EventQueuePolicy::DropOldest;
+        } else if (policy == "dropNewest") {
+            out.policy = EventQueuePolicy::DropNewest;
+        } else if (policy == "coalesce") {
+            out.policy = EventQueuePolicy::Coalesce;
+        } else {
+            Napi::TypeError::New(env, "eventQueue.policy must be 'block', 'dropOldest', 'dropNewest' or 'coalesce'").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* EventQueuePolicyName(EventQueuePolicy policy) {
+    switch (policy) {
+        case EventQueuePolicy::Block: return "block";
+        case EventQueuePolicy::DropOldest: return "dropOldest";
+        case EventQueuePolicy::DropNewest: return "dropNewest";
+        case EventQueuePolicy::Coalesce: return "coalesce";
+    }
+    return "unknown";
+}
+
+Napi::Object EventQueueStatsToNapi(Napi::Env env, const EventQueueOptions& options, const EventQueueStats& stats) {
+    Napi::Object status = Napi::Object::New(env);
+    status.Set("policy", Napi::String::New(env, EventQueuePolicyName(options.policy)));
+    status.Set("capacity", Napi::Number::New(env, static_cast<double>(options.capacity)));
+    status.Set("depth", Napi::Number::New(env, static_cast<double>(stats.depth)));
+    status.Set("highWater", Napi::Number::New(env, static_cast<double>(stats.highWater)));
+    status.Set("delivered", Napi::Number::New(env, static_cast<double>(stats.delivered)));
+    status.Set("dropped", Napi::Number::New(env, static_cast<double>(stats.dropped)));
+    status.Set("coalesced", Napi::Number::New(env, static_cast<double>(stats.coalesced)));
+    return status;
+}
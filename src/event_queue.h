@@ -0,0 +1,165 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <napi.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// What a full EventQueue does with one more event
+enum class EventQueuePolicy : uint8_t {
+    Block,       // the producing thread waits for room; where it may not, DropNewest
+    DropOldest,  // the oldest queued event is dropped
+    DropNewest,  // the new event is dropped
+    Coalesce     // a queued event with the same key is replaced; if there is none, DropOldest
+};
+
+// Constructor option eventQueue: { capacity, policy } of the clients
+struct EventQueueOptions {
+    size_t capacity = 0;  // 0: no queue, events go straight to the TSFN as before
+    EventQueuePolicy policy = EventQueuePolicy::DropOldest;
+
+    // Throws a TypeError into JS and returns false on invalid values
+    static bool Parse(Napi::Env env, Napi::Object options, EventQueueOptions& out);
+};
+
+const char* EventQueuePolicyName(EventQueuePolicy policy);
+
+struct EventQueueStats {
+    size_t depth;
+    size_t highWater;
+    uint64_t delivered;
+    uint64_t dropped;
+    uint64_t coalesced;
+};
+Napi::Object EventQueueStatsToNapi(Napi::Env env, const EventQueueOptions& options, const EventQueueStats& stats);
+
+// Bounded queue of unsolicited events between the libiec61850 threads and the JS thread. The
+// TSFN only carries wakeups: the producer that finds no drain scheduled schedules one, and the
+// drain takes everything queued at that point, so a slow consumer holds at most capacity events
+// in memory instead of an unbounded TSFN queue of captured payloads.
+template <typename T>
+class EventQueue {
+public:
+    EventQueue(size_t capacity, EventQueuePolicy policy)
+        : capacity_(capacity), policy_(policy), head_(0), scheduled_(false), closed_(false),
+          highWater_(0), delivered_(0), dropped_(0), coalesced_(0) {}
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // Queues event under key (empty: never coalesced). Returns true if the caller has to schedule
+    // a drain on the JS thread. mayBlock is false on the JS thread, which drains, and on threads
+    // that others wait for, such as the ConnectionLoop tickers.
+    bool Push(T event, const std::string& key, bool mayBlock) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (policy_ == EventQueuePolicy::Coalesce && !key.empty()) {
+            auto it = keys_.find(key);
+            if (it != keys_.end()) {
+                // The queued event keeps its place and gets the latest content
+                entries_[it->second - head_].event = std::move(event);
+                coalesced_++;
+                return false;
+            }
+        }
+        if (entries_.size() >= capacity_ && !closed_) {
+            switch (policy_) {
+                case EventQueuePolicy::Block:
+                    if (!mayBlock) {
+                        dropped_++;
+                        return false;
+                    }
+                    room_.wait(lock, [this] { return entries_.size() < capacity_ || closed_; });
+                    break;
+                case EventQueuePolicy::DropNewest:
+                    dropped_++;
+                    return false;
+                case EventQueuePolicy::DropOldest:
+                case EventQueuePolicy::Coalesce:
+                    PopFront();
+                    dropped_++;
+                    break;
+            }
+        }
+        uint64_t sequence = head_ + entries_.size();
+        entries_.push_back(Entry{std::move(event), key});
+        if (policy_ == EventQueuePolicy::Coalesce && !key.empty()) {
+            keys_[key] = sequence;
+        }
+        if (entries_.size() > highWater_) {
+            highWater_ = entries_.size();
+        }
+        bool schedule = !scheduled_;
+        scheduled_ = true;
+        return schedule;
+    }
+
+    // JS thread: takes every queued event; the next Push schedules a new drain
+    void Drain(std::vector<T>& out) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            out.reserve(out.size() + entries_.size());
+            for (Entry& entry : entries_) {
+                out.push_back(std::move(entry.event));
+            }
+            head_ += entries_.size();
+            delivered_ += entries_.size();
+            entries_.clear();
+            keys_.clear();
+            scheduled_ = false;
+        }
+        room_.notify_all();
+    }
+
+    // Releases blocked producers for good, used when the client shuts down
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        room_.notify_all();
+    }
+
+    EventQueueStats Stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return EventQueueStats{entries_.size(), highWater_, delivered_, dropped_, coalesced_};
+    }
+
+private:
+    struct Entry {
+        T event;
+        std::string key;
+    };
+
+    void PopFront() {
+        Entry& oldest = entries_.front();
+        if (!oldest.key.empty()) {
+            auto it = keys_.find(oldest.key);
+            if (it != keys_.end() && it->second == head_) keys_.erase(it);
+        }
+        entries_.pop_front();
+        head_++;
+    }
+
+    size_t capacity_;
+    EventQueuePolicy policy_;
+    std::deque<Entry> entries_;
+    std::unordered_map<std::string, uint64_t> keys_;  // Coalesce: key -> sequence of its event
+    uint64_t head_;                                   // sequence of entries_.front()
+    bool scheduled_;
+    bool closed_;
+    size_t highWater_;
+    uint64_t delivered_;
+    uint64_t dropped_;
+    uint64_t coalesced_;
+    std::mutex mutex_;
+    std::condition_variable room_;
+};
+
+#endif  // EVENT_QUEUE_H
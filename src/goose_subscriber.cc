@@ -1,11 +1,13 @@
 #include <napi.h>
 #include "goose_subscriber.h"
+#include "event_keys.h"
 #include <string>
 #include <vector>
 #include <mutex>
 #include <cstring>
 #include <iostream>
 #include <cmath>
+#include <memory>
 
 Napi::FunctionReference NodeGOOSESubscriber::constructor;
 
@@ -49,6 +51,29 @@ NodeGOOSESubscriber::NodeGOOSESubscriber(const Napi::CallbackInfo& info) : Napi:
     std::cout << "[DEBUG] GooseReceiver created\n";
     subscriber_ = nullptr;
     isSubscribed_ = false;
+    json_ = false;
+
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (!ConvertOptions::Parse(info.Env(), options, convert_)) {
+            return;
+        }
+        if (!EventQueueOptions::Parse(info.Env(), options, eventQueue_)) {
+            return;
+        }
+        if (eventQueue_.capacity > 0) {
+            events_ = std::make_unique<EventQueue<EmitCallback>>(eventQueue_.capacity, eventQueue_.policy);
+        }
+        if (options.Has("format") && options.Get("format").IsString()) {
+            std::string format = options.Get("format").As<Napi::String>().Utf8Value();
+            if (format == "json") {
+                json_ = true;
+            } else if (format != "objects") {
+                Napi::TypeError::New(info.Env(), "format must be 'objects' or 'json'").ThrowAsJavaScriptException();
+                return;
+            }
+        }
+    }
 }
 
 NodeGOOSESubscriber::~NodeGOOSESubscriber() {
@@ -72,6 +97,10 @@ void NodeGOOSESubscriber::cleanupResources() {
             subscriber_ = nullptr;
             std::cout << "[DEBUG] GooseSubscriber destroyed\n";
         }
+        if (events_) {
+            // The receiver thread may be blocked on a full queue, and stop waits for it
+            events_->Close();
+        }
         if (receiver_) {
             GooseReceiver_stop(receiver_);
             GooseReceiver_destroy(receiver_);
@@ -134,10 +163,10 @@ Napi::Value NodeGOOSESubscriber::Subscribe(const Napi::CallbackInfo& info) {
     tsfn_.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
         std::cout << "[DEBUG] Emitting 'subscribed' event\n";
         Napi::Object eventObj = Napi::Object::New(env);
-        eventObj.Set("type", Napi::String::New(env, "control"));
-        eventObj.Set("event", Napi::String::New(env, "subscribed"));
-        eventObj.Set("goCbRef", Napi::String::New(env, goCbRef_.c_str()));
-        jsCallback.Call({Napi::String::New(env, "control"), eventObj});
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "subscribed"));
+        eventObj.Set(EventKeys::Get(env, KEY_GO_CB_REF), Napi::String::New(env, goCbRef_.c_str()));
+        jsCallback.Call({EventKeys::Get(env, KEY_CONTROL), eventObj});
     });
 
     return env.Undefined();
@@ -158,10 +187,10 @@ Napi::Value NodeGOOSESubscriber::Unsubscribe(const Napi::CallbackInfo& info) {
     tsfn_.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
         std::cout << "[DEBUG] Emitting 'unsubscribed' event\n";
         Napi::Object eventObj = Napi::Object::New(env);
-        eventObj.Set("type", Napi::String::New(env, "control"));
-        eventObj.Set("event", Napi::String::New(env, "unsubscribed"));
-        eventObj.Set("goCbRef", Napi::String::New(env, goCbRef_.c_str()));
-        jsCallback.Call({Napi::String::New(env, "control"), eventObj});
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "unsubscribed"));
+        eventObj.Set(EventKeys::Get(env, KEY_GO_CB_REF), Napi::String::New(env, goCbRef_.c_str()));
+        jsCallback.Call({EventKeys::Get(env, KEY_CONTROL), eventObj});
     });
 
     return env.Undefined();
@@ -173,112 +202,38 @@ Napi::Value NodeGOOSESubscriber::GetStatus(const Napi::CallbackInfo& info) {
     std::lock_guard<std::mutex> lock(mutex_);
     Napi::Object status = Napi::Object::New(env);
     status.Set("isSubscribed", Napi::Boolean::New(env, isSubscribed_));
-    status.Set("goCbRef", Napi::String::New(env, goCbRef_.c_str()));
+    status.Set(EventKeys::Get(env, KEY_GO_CB_REF), Napi::String::New(env, goCbRef_.c_str()));
     status.Set("interfaceId", Napi::String::New(env, interfaceId_.c_str()));
+    if (events_) {
+        status.Set("events", EventQueueStatsToNapi(env, eventQueue_, events_->Stats()));
+    }
     return status;
 }
 
-ResultData NodeGOOSESubscriber::ConvertMmsValue(MmsValue* val, const std::string& attrName) {
-    std::cout << "[DEBUG] ConvertMmsValue called for attrName: " << attrName << "\n";
-    ResultData data = { MmsValue_getType(val), 0.0f, 0, false, "", {}, {}, true, "" };
-    switch (data.type) {
-        case MMS_FLOAT:
-            data.floatValue = MmsValue_toFloat(val);
-            if (std::isnan(data.floatValue) || std::isinf(data.floatValue)) {
-                data.isValid = false;
-                data.errorReason = "Invalid float value";
-                std::cout << "[ERROR] ConvertMmsValue: Invalid float value\n";
-            }
-            break;
-        case MMS_INTEGER:
-            data.intValue = MmsValue_toInt32(val);
-            break;
-        case MMS_BOOLEAN:
-            data.boolValue = MmsValue_getBoolean(val);
-            break;
-        case MMS_VISIBLE_STRING:
-            data.stringValue = MmsValue_toString(val) ? MmsValue_toString(val) : "";
-            break;
-        case MMS_UTC_TIME: {
-            uint64_t timestamp = MmsValue_getUtcTimeInMs(val);
-            time_t time = timestamp / 1000;
-            char timeStr[64];
-            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", gmtime(&time));
-            data.stringValue = std::string(timeStr) + "." + std::to_string(timestamp % 1000);
-            } break;
-        case MMS_BIT_STRING: {
-            int bitSize = MmsValue_getBitStringSize(val);
-            char bitStr[128];
-            snprintf(bitStr, sizeof(bitStr), "BitString(size=%d)", bitSize);
-            data.stringValue = bitStr;
-            } break;
-        case MMS_STRUCTURE: {
-            int size = MmsValue_getArraySize(val);
-            std::cout << "[DEBUG] ConvertMmsValue: Structure with size " << size << "\n";
-            for (int j = 0; j < size; j++) {
-                MmsValue* element = MmsValue_getElement(val, j);
-                if (element) {
-                    std::string subAttrName = attrName + ".field" + std::to_string(j);
-                    ResultData subData = ConvertMmsValue(element, subAttrName);
-                    if (subData.isValid) data.structureElements.push_back(subData);
-                }
-            }
-            } break;
-        case MMS_ARRAY: {
-            int size = MmsValue_getArraySize(val);
-            std::cout << "[DEBUG] ConvertMmsValue: Array with size " << size << "\n";
-            for (int j = 0; j < size; j++) {
-                MmsValue* element = MmsValue_getElement(val, j);
-                if (element) {
-                    ResultData subData = ConvertMmsValue(element, attrName + "[" + std::to_string(j) + "]");
-                    data.arrayElements.push_back(subData);
+void NodeGOOSESubscriber::EmitData(const std::string& goCbRef, EmitCallback callback) {
+    if (!events_) {
+        tsfn_.NonBlockingCall(callback);
+        return;
+    }
+    // Only the receiver thread produces messages, so it may always block
+    if (events_->Push(std::move(callback), goCbRef, true)) {
+        tsfn_.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
+            std::vector<EmitCallback> events;
+            events_->Drain(events);
+            for (auto& event : events) {
+                event(env, jsCallback);
+                if (env.IsExceptionPending()) {
+                    napi_fatal_exception(env, env.GetAndClearPendingException().Value());
                 }
             }
-            } break;
-        case MMS_DATA_ACCESS_ERROR:
-            data.isValid = false;
-            data.errorReason = "Data access error";
-            std::cout << "[ERROR] ConvertMmsValue: Data access error\n";
-            break;
-        default:
-            data.isValid = false;
-            data.errorReason = "Unsupported type: " + std::to_string(data.type);
-            std::cout << "[ERROR] ConvertMmsValue: Unsupported type " << data.type << "\n";
-    }
-    return data;
-}
-
-Napi::Value NodeGOOSESubscriber::ToNapiValue(Napi::Env env, const ResultData& data) {
-    std::cout << "[DEBUG] ToNapiValue called\n";
-    if (!data.isValid) {
-        std::cout << "[ERROR] ToNapiValue: Invalid data, error: " << data.errorReason << "\n";
-        return Napi::String::New(env, data.errorReason);
-    }
-    switch (data.type) {
-        case MMS_FLOAT: return Napi::Number::New(env, data.floatValue);
-        case MMS_INTEGER: return Napi::Number::New(env, data.intValue);
-        case MMS_BOOLEAN: return Napi::Boolean::New(env, data.boolValue);
-        case MMS_VISIBLE_STRING: case MMS_UTC_TIME: case MMS_BIT_STRING: return Napi::String::New(env, data.stringValue);
-        case MMS_STRUCTURE: {
-            Napi::Object structObj = Napi::Object::New(env);
-            for (size_t i = 0; i < data.structureElements.size(); i++)
-                structObj.Set(Napi::String::New(env, "field" + std::to_string(i)), ToNapiValue(env, data.structureElements[i]));
-            return structObj;
-        }
-        case MMS_ARRAY: {
-            Napi::Array array = Napi::Array::New(env, data.arrayElements.size());
-            for (size_t i = 0; i < data.arrayElements.size(); i++)
-                array.Set(uint32_t(i), ToNapiValue(env, data.arrayElements[i]));
-            return array;
-        }
-        default: return Napi::String::New(env, "Unsupported type");
+        });
     }
 }
 
 void NodeGOOSESubscriber::GooseCallback(GooseSubscriber subscriber, void* parameter) {
     NodeGOOSESubscriber* self = static_cast<NodeGOOSESubscriber*>(parameter);
     std::cout << "[DEBUG] GooseCallback triggered\n";
-    std::lock_guard<std::mutex> lock(self->mutex_);
+    std::unique_lock<std::mutex> lock(self->mutex_);
 
     const char* goCbRef = GooseSubscriber_getGoCbRef(subscriber);
     uint32_t stNum = GooseSubscriber_getStNum(subscriber);
@@ -294,40 +249,84 @@ void NodeGOOSESubscriber::GooseCallback(GooseSubscriber subscriber, void* parame
         std::cout << "[ERROR] GooseCallback: Data set is not an MMS_ARRAY, type=" << MmsValue_getType(values) << "\n";
     }
 
-    self->tsfn_.NonBlockingCall([goCbRef, stNum, sqNum, confRev, values, self](Napi::Env env, Napi::Function jsCallback) {
+    // values and goCbRef belong to the subscriber and are only valid during this callback, so
+    // they are copied before the event is handed to the JS thread
+    std::string goCbRefStr = goCbRef ? goCbRef : "";
+    int size = 0;
+    auto flatValues = std::make_shared<FlatMmsValue>(self->convert_);
+    std::vector<int> positions;
+    if (values && MmsValue_getType(values) == MMS_ARRAY) {
+        size = MmsValue_getArraySize(values);
+        for (int i = 0; i < size; i++) {
+            MmsValue* element = MmsValue_getElement(values, i);
+            if (element) {
+                flatValues->Append(element);
+                positions.push_back(i);
+            } else {
+                std::cout << "[ERROR] Null element at index " << i << "\n";
+            }
+        }
+    }
+
+    // Not held while queueing: a blocking queue waits for the JS thread, which may want the mutex
+    lock.unlock();
+
+    if (self->json_) {
+        std::string text;
+        JsonWriter json(text);
+        json.BeginObject();
+        json.Key(EventKeys::Text(KEY_TYPE));
+        json.String(EventKeys::Text(KEY_DATA));
+        json.Key(EventKeys::Text(KEY_EVENT));
+        json.String(EventKeys::Text(KEY_GOOSE));
+        json.Key(EventKeys::Text(KEY_GO_CB_REF));
+        json.String(goCbRefStr);
+        json.Key(EventKeys::Text(KEY_ST_NUM));
+        json.Uint(stNum);
+        json.Key(EventKeys::Text(KEY_SQ_NUM));
+        json.Uint(sqNum);
+        json.Key(EventKeys::Text(KEY_CONF_REV));
+        json.Uint(confRev);
+        json.Key(EventKeys::Text(KEY_VALUES));
+        json.BeginArray();
+        size_t root = 0;
+        for (int i = 0; i < size; i++) {
+            // Null elements are holes in the objects format
+            if (root < positions.size() && positions[root] == i) {
+                flatValues->WriteJson(json, root++);
+            } else {
+                json.Null();
+            }
+        }
+        json.EndArray();
+        json.EndObject();
+        self->EmitData(goCbRefStr, [text = std::move(text)](Napi::Env env, Napi::Function jsCallback) {
+            jsCallback.Call({EventKeys::Get(env, KEY_DATA), Napi::String::New(env, text)});
+        });
+        return;
+    }
+
+    self->EmitData(goCbRefStr, [goCbRefStr, stNum, sqNum, confRev, size, flatValues, positions](Napi::Env env, Napi::Function jsCallback) {
         std::cout << "[DEBUG] NonBlockingCall in GooseCallback\n";
         if (env.IsExceptionPending()) {
             std::cout << "[ERROR] NonBlockingCall: JavaScript exception pending\n";
             return;
         }
         Napi::Object eventObj = Napi::Object::New(env);
-        eventObj.Set("type", Napi::String::New(env, "data"));
-        eventObj.Set("event", Napi::String::New(env, "goose"));
-        eventObj.Set("goCbRef", Napi::String::New(env, goCbRef ? goCbRef : ""));
-        eventObj.Set("stNum", Napi::Number::New(env, stNum));
-        eventObj.Set("sqNum", Napi::Number::New(env, sqNum));
-        eventObj.Set("confRev", Napi::Number::New(env, confRev));
-
-        Napi::Array jsValues = Napi::Array::New(env);
-        if (values && MmsValue_getType(values) == MMS_ARRAY) {
-            int size = MmsValue_getArraySize(values);
-            std::cout << "[DEBUG] Processing MMS_ARRAY with size " << size << "\n";
-            jsValues = Napi::Array::New(env, size);
-            for (int i = 0; i < size; i++) {
-                MmsValue* element = MmsValue_getElement(values, i);
-                if (element) {
-                    ResultData resultData = self->ConvertMmsValue(element, "value[" + std::to_string(i) + "]");
-                    jsValues.Set(i, self->ToNapiValue(env, resultData));
-                } else {
-                    std::cout << "[ERROR] Null element at index " << i << "\n";
-                }
-            }
-        } else {
-            std::cout << "[ERROR] Invalid or missing MMS_ARRAY\n";
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_GOOSE));
+        eventObj.Set(EventKeys::Get(env, KEY_GO_CB_REF), Napi::String::New(env, goCbRefStr));
+        eventObj.Set(EventKeys::Get(env, KEY_ST_NUM), Napi::Number::New(env, stNum));
+        eventObj.Set(EventKeys::Get(env, KEY_SQ_NUM), Napi::Number::New(env, sqNum));
+        eventObj.Set(EventKeys::Get(env, KEY_CONF_REV), Napi::Number::New(env, confRev));
+
+        Napi::Array jsValues = Napi::Array::New(env, size);
+        for (size_t i = 0; i < flatValues->RootCount(); i++) {
+            jsValues.Set(uint32_t(positions[i]), flatValues->ToNapi(env, i));
         }
-        eventObj.Set("values", jsValues);
+        eventObj.Set(EventKeys::Get(env, KEY_VALUES), jsValues);
 
-        jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+        jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         std::cout << "[DEBUG] JavaScript callback invoked\n";
     });
 }
\ No newline at end of file
@@ -36,24 +36,16 @@ private:
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <functional>
 #include <iec61850_client.h>
 #include <cstdint>
 #include <goose_receiver.h>
 #include <goose_subscriber.h>
 #include <mms_value.h>
 #include <cmath>
-
-struct ResultData {
-    MmsType type;
-    float floatValue;
-    int32_t intValue;
-    bool boolValue;
-    std::string stringValue;
-    std::vector<ResultData> structureElements;
-    std::vector<ResultData> arrayElements;
-    bool isValid;
-    std::string errorReason;
-};
+#include "mms_value_converter.h"
+#include "event_queue.h"
 
 class NodeGOOSESubscriber : public Napi::ObjectWrap<NodeGOOSESubscriber> {
 public:
@@ -69,8 +61,10 @@ private:
     Napi::Value GetStatus(const Napi::CallbackInfo& info);
 
     static void GooseCallback(GooseSubscriber subscriber, void* parameter);
-    ResultData ConvertMmsValue(MmsValue* val, const std::string& attrName);
-    Napi::Value ToNapiValue(Napi::Env env, const ResultData& data);
+
+    // Messages go through events_ when the eventQueue option bounds them
+    using EmitCallback = std::function<void(Napi::Env, Napi::Function)>;
+    void EmitData(const std::string& goCbRef, EmitCallback callback);
 
     Napi::ThreadSafeFunction tsfn_;
     GooseReceiver receiver_;
@@ -79,6 +73,10 @@ private:
     std::mutex mutex_;
     bool isSubscribed_;
     std::string interfaceId_;
+    ConvertOptions convert_;
+    bool json_;  // format 'json': messages delivered as their JSON text
+    EventQueueOptions eventQueue_;
+    std::unique_ptr<EventQueue<EmitCallback>> events_;
 };
 
 #endif  // GOOSE_SUBSCRIBER_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Minimal streaming JSON writer appending to a std::string, used to serialize events on the
+// libiec61850 thread for format 'json'. It only tracks where separators go, so callers are trusted
+// to produce well-formed nesting. Several documents written one after the other with EndLine()
+// make NDJSON.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out), first_(true), afterKey_(false) {}
+
+    // The enclosing level already counts the container as a value once it is begun
+    void BeginObject() { Separator(); out_ += '{'; first_ = true; }
+    void EndObject() { out_ += '}'; first_ = false; }
+    void BeginArray() { Separator(); out_ += '['; first_ = true; }
+    void EndArray() { out_ += ']'; first_ = false; }
+
+    void Key(const char* key) { Key(key, strlen(key)); }
+    void Key(const std::string& key) { Key(key.data(), key.size()); }
+    void Key(const char* key, size_t length) {
+        Separator();
+        Quoted(key, length);
+        out_ += ':';
+        afterKey_ = true;
+    }
+
+    void String(const char* text) { String(text, strlen(text)); }
+    void String(const std::string& text) { String(text.data(), text.size()); }
+    void String(const char* text, size_t length) { Separator(); Quoted(text, length); }
+
+    void Int(int64_t value) {
+        char text[24];
+        int length = snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+        Separator();
+        out_.append(text, length);
+    }
+    void Uint(uint64_t value) {
+        char text[24];
+        int length = snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        Separator();
+        out_.append(text, length);
+    }
+    // 17 significant digits read back as the same double; callers keep NaN and Inf out
+    void Double(double value) {
+        char text[32];
+        int length = snprintf(text, sizeof(text), "%.17g", value);
+        Separator();
+        out_.append(text, length);
+    }
+    void Bool(bool value) { Separator(); out_ += value ? "true" : "false"; }
+    void Null() { Separator(); out_ += "null"; }
+    // A value that is already JSON text
+    void Raw(const std::string& json) { Separator(); out_ += json; }
+
+    // Ends an NDJSON record
+    void EndLine() { out_ += '\n'; first_ = true; }
+
+private:
+    void Separator() {
+        if (afterKey_) {
+            afterKey_ = false;
+            return;
+        }
+        if (!first_) out_ += ',';
+        first_ = false;
+    }
+
+    void Quoted(const char* text, size_t length) {
+        static const char HEX[] = "0123456789abcdef";
+        out_ += '"';
+        size_t run = 0;  // start of the pending run of characters that need no escaping
+        for (size_t i = 0; i < length; i++) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            out_.append(text + run, i - run);
+            run = i + 1;
+            switch (c) {
+                case '"': out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\n': out_ += "\\n"; break;
+                case '\r': out_ += "\\r"; break;
+                case '\t': out_ += "\\t"; break;
+                default: {
+                    char escape[] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+                    out_.append(escape, sizeof(escape));
+                }
+            }
+        }
+        out_.append(text + run, length - run);
+        out_ += '"';
+    }
+
+    std::string& out_;
+    bool first_;     // no value written yet at the current nesting level
+    bool afterKey_;  // the next value belongs to the key just written
+};
+
+#endif  // JSON_WRITER_H
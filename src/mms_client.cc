@@ -1,4 +1,5 @@
 #include "mms_client.h"
+#include "event_keys.h"
 #include <cmath>
 #include <string>
 #include <thread>
@@ -8,18 +9,33 @@
 #include <functional>
 #include <ctime>
 #include <cinttypes>
+#include <algorithm>
+#include <map>
 
 Napi::FunctionReference MmsClient::constructor;
 
-struct ConnectionHandlerContext {
-    MmsClient* client;
-    std::mutex* mutex;
+// Size estimates used to pack readMany() requests into the negotiated MMS PDU size
+static const int READ_MANY_PDU_OVERHEAD = 32;
+static const int READ_MANY_ITEM_OVERHEAD = 16;
+static const int READ_MANY_VALUE_SIZE = 24;
+
+// Node loop mode: ticks per timer callback while a connection is busy
+static const int NODE_LOOP_MAX_TICKS = 16;
+
+// All node loop clients of a JS thread share one timer, which fires at the earliest of their deadlines
+struct NodeLoopTimer {
+    uv_timer_t* handle = nullptr;
+    std::vector<MmsClient*> clients;
+    bool running = false;  // inside NodeLoopTick
+    bool kicked = false;   // work arrived during NodeLoopTick
 };
+static thread_local NodeLoopTimer nodeLoopTimer;
 
 Napi::Object MmsClient::Init(Napi::Env env, Napi::Object exports) {
     Napi::Function func = DefineClass(env, "MmsClient", {
         InstanceMethod("connect", &MmsClient::Connect),
         InstanceMethod("readData", &MmsClient::ReadData),        
+        InstanceMethod("readMany", &MmsClient::ReadMany),
         InstanceMethod("controlObject", &MmsClient::ControlObject),
         InstanceMethod("close", &MmsClient::Close),
         InstanceMethod("getStatus", &MmsClient::GetStatus),
@@ -30,7 +46,8 @@ Napi::Object MmsClient::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("getDataSetDirectory", &MmsClient::GetDataSetDirectory),
         InstanceMethod("browseDataModel", &MmsClient::BrowseDataModel),
         InstanceMethod("enableReporting", &MmsClient::EnableReporting),
-        InstanceMethod("disableReporting", &MmsClient::DisableReporting)        
+        InstanceMethod("disableReporting", &MmsClient::DisableReporting),
+        InstanceMethod("reserveReport", &MmsClient::ReserveReport)
     });
 
     constructor = Napi::Persistent(func);
@@ -39,18 +56,72 @@ Napi::Object MmsClient::Init(Napi::Env env, Napi::Object exports) {
     return exports;
 }
 
-MmsClient::MmsClient(const Napi::CallbackInfo& info) : Napi::ObjectWrap<MmsClient>(info) {
+MmsClient::MmsClient(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<MmsClient>(info), pipeline_(false), requestedWindow_(10), windowLimit_(10), pipelineWindow_(10), inFlight_(0),
+      running_(false), connected_(false), usingPrimaryIp_(true), port_(0), reconnectDelay_(5), isPrimary_(true),
+      primaryRetryCount_(0), reserveRetryCount_(0), threadless_(false), connecting_(false), probing_(false),
+      nodeLoop_(false), inNodeTick_(false), jsThread_(std::this_thread::get_id()),
+      promiseOnly_(false), format_(ValueFormat::Objects), namedFields_(false), sparseReports_(false), requestTimeout_(0),
+      batchMaxReports_(0), batchMaxLatency_(0), batchJsonCount_(0), batchPending_(false) {
     if (info.Length() < 1 || !info[0].IsFunction()) {
         Napi::TypeError::New(info.Env(), "Expected a callback function").ThrowAsJavaScriptException();
         return;
     }
 
     Napi::Function emit = info[0].As<Napi::Function>();
-    connection_ = IedConnection_create();
-    running_ = false;
-    connected_ = false;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("promiseOnly") && options.Get("promiseOnly").IsBoolean()) {
+            promiseOnly_ = options.Get("promiseOnly").As<Napi::Boolean>().Value();
+        }
+        if (!ConvertOptions::Parse(info.Env(), options, convert_)) {
+            return;
+        }
+        if (options.Has("namedFields") && options.Get("namedFields").IsBoolean()) {
+            namedFields_ = options.Get("namedFields").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("sparseReports") && options.Get("sparseReports").IsBoolean()) {
+            sparseReports_ = options.Get("sparseReports").As<Napi::Boolean>().Value();
+        }
+        if (!EventQueueOptions::Parse(info.Env(), options, eventQueue_)) {
+            return;
+        }
+        if (eventQueue_.capacity > 0) {
+            events_ = std::make_unique<EventQueue<EmitCallback>>(eventQueue_.capacity, eventQueue_.policy);
+        }
+        if (options.Has("journalPath") && options.Get("journalPath").IsString()) {
+            journal_ = std::make_unique<ReportJournal>(options.Get("journalPath").As<Napi::String>().Utf8Value());
+        }
+        if (options.Has("reportBatch") && options.Get("reportBatch").IsObject()) {
+            Napi::Object batch = options.Get("reportBatch").As<Napi::Object>();
+            batchMaxReports_ = 100;
+            batchMaxLatency_ = std::chrono::milliseconds(5);
+            if (batch.Has("maxReports") && batch.Get("maxReports").IsNumber()) {
+                batchMaxReports_ = std::max<int64_t>(1, batch.Get("maxReports").As<Napi::Number>().Int64Value());
+            }
+            if (batch.Has("maxLatencyMs") && batch.Get("maxLatencyMs").IsNumber()) {
+                batchMaxLatency_ = std::chrono::milliseconds(std::max<int64_t>(0, batch.Get("maxLatencyMs").As<Napi::Number>().Int64Value()));
+            }
+        }
+        if (options.Has("format") && options.Get("format").IsString()) {
+            std::string format = options.Get("format").As<Napi::String>().Utf8Value();
+            if (format == "columnar") {
+                format_ = ValueFormat::Columnar;
+            } else if (format == "binary") {
+                format_ = ValueFormat::Binary;
+            } else if (format == "json") {
+                format_ = ValueFormat::Json;
+            } else if (format != "objects") {
+                Napi::TypeError::New(info.Env(), "format must be 'objects', 'columnar', 'binary' or 'json'").ThrowAsJavaScriptException();
+                return;
+            }
+        }
+    }
+    // Created by connect(), which knows whether the connection runs threaded or on the shared loop
+    connection_ = nullptr;
+    emit_ = Napi::Persistent(emit);
     clientID_ = "mms_client";
-    usingPrimaryIp_ = true;
+    clientIdValue_ = Napi::Reference<Napi::String>::New(Napi::String::New(info.Env(), clientID_), 1);
     try {
         tsfn_ = Napi::ThreadSafeFunction::New(
             info.Env(),
@@ -67,23 +138,20 @@ MmsClient::MmsClient(const Napi::CallbackInfo& info) : Napi::ObjectWrap<MmsClien
 }
 
 MmsClient::~MmsClient() {
-    std::lock_guard<std::mutex> lock(connMutex_);
-    if (running_) {
-        running_ = false;
-        if (connected_) {
-            printf("Destructor closing connection, clientID: %s\n", clientID_.c_str());
-            IedConnection_close(connection_);
-            connected_ = false;
-        }
-    }
+    StopIoThread();
 
     // Cleanup active reports
     for (auto& [rcbRef, reportInfo] : activeReports_) {
         printf("Cleaning up report for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
+        if (connection_) {
+            IedConnection_uninstallReportHandler(connection_, rcbRef.c_str());
+        }
         if (reportInfo.rcb) {
-            ClientReportControlBlock_setRptEna(reportInfo.rcb, false);
-            IedClientError error;
-            IedConnection_setRCBValues(connection_, &error, reportInfo.rcb, RCB_ELEMENT_RPT_ENA, true);
+            if (connection_) {
+                ClientReportControlBlock_setRptEna(reportInfo.rcb, false);
+                IedClientError error;
+                IedConnection_setRCBValues(connection_, &error, reportInfo.rcb, RCB_ELEMENT_RPT_ENA, true);
+            }
             ClientReportControlBlock_destroy(reportInfo.rcb);
         }
         if (reportInfo.dataSet) {
@@ -94,10 +162,7 @@ MmsClient::~MmsClient() {
         }
     }
     activeReports_.clear();
-
-    if (thread_.joinable()) {
-        thread_.join();
-    }
+    if (journal_) journal_->Flush();
 
     if (connection_) {
         IedConnection_destroy(connection_);
@@ -109,10 +174,621 @@ MmsClient::~MmsClient() {
     }
 }
 
+// Runs every command queued so far. Only called on the I/O thread, which is the sole user of
+// connection_ for requests, so commands never need a lock around their network round trips.
+void MmsClient::DrainCommands() {
+    CommandQueue::Command command;
+    while (commands_.Pop(command)) {
+        command();
+        command = nullptr;
+    }
+}
+
+// Queues a command for the connection actor. A threadless client has no thread of its own
+// to wake, so it asks the shared loop for a worker instead.
+void MmsClient::Post(CommandQueue::Command command) {
+    Post(CommandQueue::LANE_INTERNAL, std::move(command));
+}
+
+void MmsClient::Post(CommandQueue::Lane lane, CommandQueue::Command command) {
+    commands_.Push(std::move(command), lane);
+    if (threadless_ && running_) {
+        ConnectionLoop::Instance().Schedule(this);
+        if (nodeLoop_ && std::this_thread::get_id() == jsThread_) {
+            // The command's request is about to go out: tick now instead of at the idle deadline
+            KickNodeLoop();
+        }
+    }
+}
+
+void MmsClient::Defer(std::chrono::steady_clock::duration delay, CommandQueue::Command command) {
+    std::lock_guard<std::mutex> lock(deferredMutex_);
+    deferred_.emplace(std::chrono::steady_clock::now() + delay, std::move(command));
+}
+
+// Queues the deferred commands that are due and returns when the next one is
+std::chrono::steady_clock::time_point MmsClient::PostDueCommands(std::chrono::steady_clock::time_point now) {
+    std::vector<CommandQueue::Command> due;
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::time_point::max();
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex_);
+        auto end = deferred_.upper_bound(now);
+        for (auto it = deferred_.begin(); it != end; ++it) {
+            due.push_back(std::move(it->second));
+        }
+        deferred_.erase(deferred_.begin(), end);
+        if (!deferred_.empty()) {
+            next = deferred_.begin()->first;
+        }
+    }
+    for (CommandQueue::Command& command : due) {
+        Post(CommandQueue::LANE_CONTROL, std::move(command));
+    }
+    return next;
+}
+
+MmsClient::ReplyPtr MmsClient::NewReply(Napi::Env env) {
+    return promiseOnly_ ? std::make_shared<Reply>(env) : nullptr;
+}
+
+Napi::Value MmsClient::ReplyValue(Napi::Env env, const ReplyPtr& reply) {
+    return reply ? reply->deferred.Promise() : env.Undefined();
+}
+
+// Failures detected before anything is queued: thrown in event mode, rejected in promise-only mode
+Napi::Value MmsClient::Fail(Napi::Env env, const ReplyPtr& reply, const std::string& reason) {
+    if (!reply) {
+        Napi::Error::New(env, reason).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    reply->settled = true;
+    reply->deferred.Reject(Napi::Error::New(env, reason).Value());
+    return reply->deferred.Promise();
+}
+
+// Settles a promise-only call with the event it would have emitted: error events reject with an
+// Error carrying the event fields, anything else resolves with the event object. Returns false in
+// event mode so the caller emits as before. Later events of the same call are dropped.
+bool MmsClient::Settle(const ReplyPtr& reply, Napi::Env env, Napi::Object eventObj) {
+    if (!reply) {
+        return false;
+    }
+    if (reply->settled) {
+        return true;
+    }
+    reply->settled = true;
+    Napi::Value type = eventObj.Get("type");
+    if (type.IsString() && type.As<Napi::String>().Utf8Value() == "error") {
+        Napi::Value reason = eventObj.Get("reason");
+        Napi::Error error = Napi::Error::New(env, reason.IsString() ? reason.As<Napi::String>().Utf8Value() : "Request failed");
+        Napi::Array keys = eventObj.GetPropertyNames();
+        for (uint32_t i = 0; i < keys.Length(); i++) {
+            std::string key = keys.Get(i).As<Napi::String>().Utf8Value();
+            if (key != "clientID" && key != "type" && key != "reason") {
+                error.Set(key.c_str(), eventObj.Get(key.c_str()));
+            }
+        }
+        reply->deferred.Reject(error.Value());
+    } else {
+        reply->deferred.Resolve(eventObj);
+    }
+    return true;
+}
+
+bool MmsClient::Resolve(const ReplyPtr& reply, Napi::Value result) {
+    if (!reply) {
+        return false;
+    }
+    if (!reply->settled) {
+        reply->settled = true;
+        reply->deferred.Resolve(result);
+    }
+    return true;
+}
+
+void MmsClient::BeginJsonEvent(JsonWriter& json, const std::string& clientID, const char* event) {
+    json.BeginObject();
+    json.Key(EventKeys::Text(KEY_CLIENT_ID));
+    json.String(clientID);
+    json.Key(EventKeys::Text(KEY_TYPE));
+    json.String(EventKeys::Text(KEY_DATA));
+    if (event) {
+        json.Key(EventKeys::Text(KEY_EVENT));
+        json.String(event);
+    }
+}
+
+// Reads the per-call options object { timeout: ms, signal: AbortSignal } of a request method.
+// Aborting only flags the request; the I/O thread drops it instead of sending it.
+MmsClient::CallOptions MmsClient::ParseCallOptions(Napi::Env env, Napi::Value value) {
+    CallOptions options;
+    if (!value.IsObject()) {
+        return options;
+    }
+    Napi::Object object = value.As<Napi::Object>();
+    if (object.Has("timeout") && object.Get("timeout").IsNumber()) {
+        int64_t timeout = object.Get("timeout").As<Napi::Number>().Int64Value();
+        options.timeoutMs = timeout > 0 ? static_cast<uint32_t>(timeout) : 0;
+    }
+    if (object.Has("signal") && object.Get("signal").IsObject()) {
+        Napi::Object signal = object.Get("signal").As<Napi::Object>();
+        auto aborted = std::make_shared<std::atomic<bool>>(signal.Get("aborted").ToBoolean().Value());
+        options.aborted = aborted;
+        Napi::Value addEventListener = signal.Get("addEventListener");
+        if (!aborted->load() && addEventListener.IsFunction()) {
+            Napi::Function listener = Napi::Function::New(env, [aborted](const Napi::CallbackInfo&) {
+                aborted->store(true);
+            });
+            Napi::Object listenerOptions = Napi::Object::New(env);
+            listenerOptions.Set("once", Napi::Boolean::New(env, true));
+            addEventListener.As<Napi::Function>().Call(signal, {Napi::String::New(env, "abort"), listener, listenerOptions});
+        }
+    }
+    return options;
+}
+
+Napi::Value MmsClient::AbortError(Napi::Env env) {
+    Napi::Error error = Napi::Error::New(env, "The operation was aborted");
+    error.Set("name", Napi::String::New(env, "AbortError"));
+    return error.Value();
+}
+
+void MmsClient::RejectAborted(Napi::Promise::Deferred deferred) {
+    tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+        deferred.Reject(AbortError(env));
+    });
+}
+
+void MmsClient::EmitAborted(ReplyPtr reply, const std::string& method) {
+    printf("%s: Aborted before it was sent, clientID: %s\n", method.c_str(), clientID_.c_str());
+    tsfn_.NonBlockingCall([this, reply, method](Napi::Env env, Napi::Function jsCallback) {
+        Napi::Object eventObj = Napi::Object::New(env);
+        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+        eventObj.Set(EventKeys::Get(env, KEY_NAME), Napi::String::New(env, "AbortError"));
+        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, method + " aborted"));
+        if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+    });
+}
+
+MmsClient::RequestTimeoutScope::RequestTimeoutScope(IedConnection connection, uint32_t timeoutMs, uint32_t defaultMs)
+    : connection_(connection), defaultMs_(defaultMs), active_(timeoutMs > 0 && timeoutMs != defaultMs) {
+    if (active_) {
+        IedConnection_setRequestTimeout(connection_, timeoutMs);
+    }
+}
+
+MmsClient::RequestTimeoutScope::~RequestTimeoutScope() {
+    if (active_) {
+        IedConnection_setRequestTimeout(connection_, defaultMs_);
+    }
+}
+
+// Stops the actor: the I/O thread closes the connection and settles whatever is still queued
+void MmsClient::StopIoThread() {
+    if (events_) {
+        // A producer blocked on a full queue would otherwise never see the connection close
+        events_->Close();
+    }
+    if (threadless_) {
+        bool wasRunning = running_.exchange(false);
+        if (wasRunning) {
+            // Closed before the removal waits for the worker, so a blocking request still waiting
+            // for its response fails at the next tick instead of running into its timeout
+            if (connected_ || connecting_) {
+                printf("Closing connection, clientID: %s\n", clientID_.c_str());
+                IedConnection_close(connection_);
+            }
+            connected_ = false;
+            connecting_ = false;
+            // Once removed, no ticker or worker touches this client any more. In node loop mode the
+            // removal ticks the connection itself, the timer only stops after it.
+            ConnectionLoop::Instance().Remove(this);
+        }
+        StopNodeLoop();
+        FlushReports();
+        if (journal_) journal_->Flush();
+        PostDueCommands(std::chrono::steady_clock::time_point::max());
+        DrainCommands();
+        return;
+    }
+    if (running_.exchange(false)) {
+        if (connected_) {
+            printf("Closing connection, clientID: %s\n", clientID_.c_str());
+            IedConnection_close(connection_);
+        }
+    }
+    commands_.Notify();
+    if (ioThread_.joinable()) {
+        ioThread_.join();
+    }
+    DrainCommands();
+}
+
+// Events raised inside a node loop tick are queued and delivered right after it; everything
+// else (worker threads, the threaded modes) goes through the TSFN
+void MmsClient::Emit(EmitCallback callback) {
+    if (inNodeTick_ && std::this_thread::get_id() == jsThread_) {
+        nodeLoopEvents_.push_back(std::move(callback));
+        return;
+    }
+    tsfn_.NonBlockingCall(callback);
+}
+
+void MmsClient::EmitData(const std::string& key, EmitCallback callback) {
+    if (!events_) {
+        Emit(std::move(callback));
+        return;
+    }
+    // Threadless reports come from a ticker holding its shard, or from the JS thread itself:
+    // waiting there would stall every connection of the shard, or never end
+    bool mayBlock = !threadless_ && std::this_thread::get_id() != jsThread_;
+    if (events_->Push(std::move(callback), key, mayBlock)) {
+        Emit([this](Napi::Env env, Napi::Function jsCallback) { DrainEvents(env, jsCallback); });
+    }
+}
+
+// JS thread
+void MmsClient::DrainEvents(Napi::Env env, Napi::Function jsCallback) {
+    std::vector<EmitCallback> events;
+    events_->Drain(events);
+    for (auto& event : events) {
+        event(env, jsCallback);
+        if (env.IsExceptionPending()) {
+            napi_fatal_exception(env, env.GetAndClearPendingException().Value());
+        }
+    }
+}
+
+void MmsClient::StartNodeLoop(Napi::Env env) {
+    if (!asyncContext_) {
+        asyncContext_ = std::make_unique<Napi::AsyncContext>(env, "MmsClientNodeLoop");
+    }
+    NodeLoopTimer& timer = nodeLoopTimer;
+    if (!timer.handle) {
+        uv_loop_t* loop = nullptr;
+        napi_get_uv_event_loop(env, &loop);
+        timer.handle = new uv_timer_t;
+        uv_timer_init(loop, timer.handle);
+        // The TSFNs already keep the process alive while clients are open
+        uv_unref(reinterpret_cast<uv_handle_t*>(timer.handle));
+    }
+    if (std::find(timer.clients.begin(), timer.clients.end(), this) == timer.clients.end()) {
+        timer.clients.push_back(this);
+    }
+    KickNodeLoop();
+}
+
+// JS thread only
+void MmsClient::StopNodeLoop() {
+    NodeLoopTimer& timer = nodeLoopTimer;
+    auto it = std::find(timer.clients.begin(), timer.clients.end(), this);
+    if (it == timer.clients.end()) {
+        return;
+    }
+    timer.clients.erase(it);
+    if (timer.clients.empty() && !timer.running) {
+        uv_timer_stop(timer.handle);
+        uv_close(reinterpret_cast<uv_handle_t*>(timer.handle), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_timer_t*>(handle);
+        });
+        timer.handle = nullptr;
+    }
+}
+
+// JS thread only: runs the timer right away
+void MmsClient::KickNodeLoop() {
+    NodeLoopTimer& timer = nodeLoopTimer;
+    if (timer.running) {
+        timer.kicked = true;
+    } else if (timer.handle) {
+        uv_timer_start(timer.handle, NodeLoopTick, 0, 0);
+    }
+}
+
+void MmsClient::NodeLoopTick(uv_timer_t* handle) {
+    NodeLoopTimer& timer = nodeLoopTimer;
+    timer.running = true;
+    timer.kicked = false;
+    auto now = std::chrono::steady_clock::now();
+    auto next = now + ConnectionLoop::TICK_IDLE_MAX;
+    // Handlers may open or close clients, so the round works on a copy. A client closed by an
+    // earlier handler still gets its events, which may settle its pending promises.
+    std::vector<MmsClient*> clients = timer.clients;
+    for (MmsClient* client : clients) {
+        next = std::min(next, client->NodeLoopRound(now));
+    }
+    for (MmsClient* client : clients) {
+        client->DeliverNodeLoopEvents();
+    }
+    timer.running = false;
+
+    if (timer.clients.empty()) {
+        uv_close(reinterpret_cast<uv_handle_t*>(handle), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_timer_t*>(handle);
+        });
+        timer.handle = nullptr;
+        return;
+    }
+    uint64_t delay = 0;
+    if (!timer.kicked) {
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(next - std::chrono::steady_clock::now());
+        delay = wait.count() > 0 ? static_cast<uint64_t>(wait.count()) : 0;
+    }
+    uv_timer_start(handle, NodeLoopTick, delay, 0);
+}
+
+// Ticks one client and returns when it needs the timer again: right away while responses are
+// still coming in, every millisecond while a request is outstanding, else by its NextTick()
+std::chrono::steady_clock::time_point MmsClient::NodeLoopRound(std::chrono::steady_clock::time_point now) {
+    inNodeTick_ = true;
+    bool idle = false;
+    for (int i = 0; i < NODE_LOOP_MAX_TICKS && !idle; i++) {
+        idle = OnTick(now);
+    }
+    inNodeTick_ = false;
+
+    bool commands = HasCommands();
+    if (commands) {
+        ConnectionLoop::Instance().Schedule(this);
+    }
+    if (!idle) {
+        return now;
+    }
+    if (commands || InWorker()) {
+        return now + std::chrono::milliseconds(1);
+    }
+    return NextTick(now);
+}
+
+// Delivered after the ticks so a handler may safely call close(), which leaves the timer
+void MmsClient::DeliverNodeLoopEvents() {
+    std::vector<EmitCallback> events;
+    events.swap(nodeLoopEvents_);
+    if (events.empty()) {
+        return;
+    }
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+    Napi::CallbackScope callbackScope(env, *asyncContext_);
+    Napi::Function emit = emit_.Value();
+    for (auto& event : events) {
+        event(env, emit);
+        if (env.IsExceptionPending()) {
+            napi_fatal_exception(env, env.GetAndClearPendingException().Value());
+        }
+    }
+}
+
+void MmsClient::OnConnected() {
+    printf("Connected successfully to %s:%d, clientID: %s\n", currentIp_.c_str(), port_, clientID_.c_str());
+    usingPrimaryIp_ = isPrimary_;
+    primaryRetryCount_ = 0;
+    reserveRetryCount_ = 0;
+    nextPrimaryProbe_ = std::chrono::steady_clock::now() + std::chrono::seconds(reconnectDelay_);
+    // Queued behind the commands already waiting, so reports enabled before the drop come back
+    Post(CommandQueue::LANE_REPORTS, [this]() { RearmReports(); });
+    Emit([this](Napi::Env env, Napi::Function jsCallback) {
+        if (env.IsExceptionPending()) {
+            printf("Connect: Exception pending in env, clientID: %s\n", clientID_.c_str());
+            return;
+        }
+        Napi::Object eventObj = Napi::Object::New(env);
+        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "opened"));
+        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "connection established"));
+        eventObj.Set("isPrimaryIP", Napi::Boolean::New(env, usingPrimaryIp_.load()));
+        jsCallback.Call({EventKeys::Get(env, KEY_CONN), eventObj});
+    });
+}
+
+// Reports the failed attempt and decides which address the next one goes to
+void MmsClient::OnConnectFailed(IedClientError error) {
+    const int maxRetries = 3;
+    printf("Connection failed to %s:%d, error: %d, clientID: %s\n", currentIp_.c_str(), port_, error, clientID_.c_str());
+    Emit([this, currentIp = currentIp_, isPrimary = isPrimary_, retryCount = (isPrimary_ ? primaryRetryCount_ : reserveRetryCount_)](Napi::Env env, Napi::Function jsCallback) {
+        if (env.IsExceptionPending()) {
+            printf("Connect: Exception pending in env, clientID: %s\n", clientID_.c_str());
+            return;
+        }
+        Napi::Object eventObj = Napi::Object::New(env);
+        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "reconnecting"));
+        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("attempt ") + std::to_string(retryCount + 1) + " to " + currentIp));
+        eventObj.Set("isPrimaryIP", Napi::Boolean::New(env, isPrimary));
+        std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+        jsCallback.Call(args);
+    });
+
+    if (isPrimary_) {
+        primaryRetryCount_++;
+    } else {
+        reserveRetryCount_++;
+    }
+
+    if (isPrimary_ && primaryRetryCount_ >= maxRetries && !ipReserve_.empty()) {
+        printf("Primary IP %s unresponsive after %d attempts, switching to reserve IP %s, clientID: %s\n",
+               ip_.c_str(), maxRetries, ipReserve_.c_str(), clientID_.c_str());
+        currentIp_ = ipReserve_;
+        isPrimary_ = false;
+        primaryRetryCount_ = 0;
+        reserveRetryCount_ = 0;
+    } else if (!isPrimary_ && reserveRetryCount_ >= maxRetries) {
+        printf("Reserve IP %s unresponsive after %d attempts, switching back to primary IP %s, clientID: %s\n",
+               ipReserve_.c_str(), maxRetries, ip_.c_str(), clientID_.c_str());
+        currentIp_ = ip_;
+        isPrimary_ = true;
+        reserveRetryCount_ = 0;
+        primaryRetryCount_ = 0;
+    }
+    printf("Reconnection attempt failed, retrying in %d seconds, clientID: %s\n", reconnectDelay_, clientID_.c_str());
+}
+
+void MmsClient::IoLoop() {
+    const int maxRetries = 3;
+
+    while (running_) {
+        if (!connected_) {
+            // Reports received before the association was lost
+            FlushReports();
+            printf("Attempting to connect to %s:%d (attempt %d/%d), clientID: %s\n",
+                   currentIp_.c_str(), port_, (isPrimary_ ? primaryRetryCount_ : reserveRetryCount_) + 1, maxRetries, clientID_.c_str());
+            IedClientError error;
+            IedConnection_connect(connection_, &error, currentIp_.c_str(), port_);
+            connected_ = (error == IED_ERROR_OK);
+
+            if (connected_) {
+                // Calls outstanding on a previous association will never be answered, and the
+                // server model may have changed while we were away
+                inFlight_ = 0;
+                ApplyNegotiatedWindow();
+                ClearModelCaches();
+                PumpPipelined();
+                OnConnected();
+                continue;
+            }
+
+            OnConnectFailed(error);
+
+            // Keep serving the mailbox while waiting, queued commands fail fast with "Not connected"
+            auto retryAt = std::chrono::steady_clock::now() + std::chrono::seconds(reconnectDelay_);
+            while (running_ && std::chrono::steady_clock::now() < retryAt) {
+                PostDueCommands(std::chrono::steady_clock::now());
+                DrainCommands();
+                commands_.Wait(std::chrono::duration_cast<std::chrono::milliseconds>(retryAt - std::chrono::steady_clock::now()));
+            }
+            continue;
+        }
+
+        DrainCommands();
+        auto now = std::chrono::steady_clock::now();
+        FlushReportsIfDue(now);
+        if (journal_) journal_->FlushIfDue(now);
+        auto nextDeferred = PostDueCommands(now);
+
+        if (!isPrimary_ && !ipReserve_.empty() && std::chrono::steady_clock::now() >= nextPrimaryProbe_) {
+            ProbePrimary();
+            continue;
+        }
+
+        std::chrono::milliseconds wait = ReportFlushWait(std::chrono::seconds(1));
+        if (nextDeferred - now < wait) {
+            wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextDeferred - now) + std::chrono::milliseconds(1);
+        }
+        commands_.Wait(wait);
+    }
+
+    if (connected_) {
+        printf("Thread stopped by client, closing connection, clientID: %s\n", clientID_.c_str());
+        IedConnection_close(connection_);
+        connected_ = false;
+    }
+    FlushReports();
+    if (journal_) journal_->Flush();
+    PostDueCommands(std::chrono::steady_clock::time_point::max());
+    DrainCommands();
+}
+
+// While on the reserve IP, checks whether the primary answers again and drops the current
+// association if so; the reconnect logic then connects to the primary
+void MmsClient::ProbePrimary() {
+    nextPrimaryProbe_ = std::chrono::steady_clock::now() + std::chrono::seconds(reconnectDelay_);
+    IedConnection testConn = IedConnection_create();
+    IedConnection_setConnectTimeout(testConn, 1000);
+    IedClientError testError;
+    IedConnection_connect(testConn, &testError, ip_.c_str(), port_);
+    if (testError == IED_ERROR_OK) {
+        IedConnection_close(testConn);
+        IedConnection_destroy(testConn);
+        printf("Switching back to primary IP %s, clientID: %s\n", ip_.c_str(), clientID_.c_str());
+        currentIp_ = ip_;
+        isPrimary_ = true;
+        IedConnection_close(connection_);
+        connected_ = false;
+        return;
+    }
+    IedConnection_destroy(testConn);
+}
+
+// Ticker thread of the shared loop. Handles received messages and time-driven work; anything
+// that may block (requests, the primary probe) goes to the command queue and runs on a worker.
+bool MmsClient::OnTick(std::chrono::steady_clock::time_point now) {
+    bool idle = IedConnection_tick(connection_);
+    if (!running_) {
+        return idle;
+    }
+    FlushReportsIfDue(now);
+    if (journal_) journal_->FlushIfDue(now);
+    PostDueCommands(now);
+
+    if (!connected_ && !connecting_ && now >= nextAttempt_) {
+        printf("Attempting to connect to %s:%d (attempt %d), clientID: %s\n",
+               currentIp_.c_str(), port_, (isPrimary_ ? primaryRetryCount_ : reserveRetryCount_) + 1, clientID_.c_str());
+        connecting_ = true;
+        IedClientError error;
+        IedConnection_connectAsync(connection_, &error, currentIp_.c_str(), port_);
+        if (error != IED_ERROR_OK) {
+            connecting_ = false;
+            OnConnectFailed(error);
+            nextAttempt_ = now + std::chrono::seconds(reconnectDelay_);
+        }
+        return false;
+    }
+
+    if (connected_ && !isPrimary_ && !ipReserve_.empty() && now >= nextPrimaryProbe_ && !probing_) {
+        probing_ = true;
+        nextPrimaryProbe_ = now + std::chrono::seconds(reconnectDelay_);
+        Post([this]() {
+            if (connected_ && !isPrimary_) {
+                ProbePrimary();
+            }
+            probing_ = false;
+        });
+    }
+    return idle;
+}
+
+// Responses are only read by a tick: a connection with requests on the wire or an association
+// being set up is ticked right away, otherwise by its next deadline. Reports can arrive at any
+// time, which the ticker covers with its TICK_IDLE_MAX bound.
+std::chrono::steady_clock::time_point MmsClient::NextTick(std::chrono::steady_clock::time_point now) {
+    if (connecting_ || inFlight_ > 0) {
+        return now + std::chrono::milliseconds(1);
+    }
+    std::chrono::steady_clock::time_point next = now + ConnectionLoop::TICK_IDLE_MAX;
+    if (!connected_ && nextAttempt_ < next) {
+        next = nextAttempt_;
+    }
+    if (batchPending_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(batchMutex_);
+        next = std::min(next, batchDeadline_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex_);
+        if (!deferred_.empty()) {
+            next = std::min(next, deferred_.begin()->first);
+        }
+    }
+    return next;
+}
+
+bool MmsClient::RunCommand() {
+    CommandQueue::Command command;
+    if (!commands_.Pop(command)) {
+        return false;
+    }
+    command();
+    return true;
+}
+
+bool MmsClient::HasCommands() {
+    return commands_.Size() > 0;
+}
+
 void MmsClient::ConnectionHandler(void* parameter, IedConnection connection, IedConnectionState newState) {
-    ConnectionHandlerContext* context = static_cast<ConnectionHandlerContext*>(parameter);
-    MmsClient* client = context->client;
-    std::mutex* mutex = context->mutex;
+    MmsClient* client = static_cast<MmsClient*>(parameter);
 
     std::string stateStr;
     bool isConnected = false;
@@ -138,24 +814,45 @@ void MmsClient::ConnectionHandler(void* parameter, IedConnection connection, Ied
             isConnected = false;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(*mutex);
-        client->connected_ = isConnected;
+    bool wasConnected = client->connected_.exchange(isConnected);
+    if (client->threadless_) {
+        // Called from IedConnection_tick on the ticker thread, which drives the reconnect logic
+        if (isConnected && !wasConnected) {
+            client->connecting_ = false;
+            client->OnConnected();
+            client->Post([client]() {
+                client->inFlight_ = 0;
+                client->ApplyNegotiatedWindow();
+                client->ClearModelCaches();
+                client->PumpPipelined();
+            });
+        } else if (newState == IED_STATE_CLOSED && client->running_) {
+            if (client->connecting_) {
+                client->connecting_ = false;
+                client->OnConnectFailed(IED_ERROR_CONNECTION_REJECTED);
+                client->nextAttempt_ = std::chrono::steady_clock::now() + std::chrono::seconds(client->reconnectDelay_);
+            } else if (wasConnected) {
+                client->nextAttempt_ = std::chrono::steady_clock::now();
+            }
+        }
+    } else if (!isConnected) {
+        // Wake the I/O thread so it starts reconnecting right away
+        client->commands_.Notify();
     }
 
     printf("Connection state changed to %s, clientID: %s\n", stateStr.c_str(), client->clientID_.c_str());
-    client->tsfn_.NonBlockingCall([client, stateStr, isConnected](Napi::Env env, Napi::Function jsCallback) {
+    client->Emit([client, stateStr, isConnected](Napi::Env env, Napi::Function jsCallback) {
         if (env.IsExceptionPending()) {
             printf("ConnectionHandler: Exception pending in env, clientID: %s\n", client->clientID_.c_str());
             return;
         }
         Napi::Object eventObj = Napi::Object::New(env);
-        eventObj.Set("clientID", Napi::String::New(env, client->clientID_.c_str()));
-        eventObj.Set("type", Napi::String::New(env, "control"));
-        eventObj.Set("event", Napi::String::New(env, "stateChanged"));
+        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), client->ClientIdValue(env));
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "stateChanged"));
         eventObj.Set("state", Napi::String::New(env, stateStr));
         eventObj.Set("isConnected", Napi::Boolean::New(env, isConnected));
-        std::vector<napi_value> args = {Napi::String::New(env, "conn"), eventObj};
+        std::vector<napi_value> args = {EventKeys::Get(env, KEY_CONN), eventObj};
         jsCallback.Call(args);
     });
 }
@@ -177,9 +874,15 @@ Napi::Value MmsClient::Connect(const Napi::CallbackInfo& info) {
         return env.Undefined();
     }
 
+    ReplyPtr reply = NewReply(env);
+    if (running_) {
+        return Fail(env, reply, "Client already running");
+    }
+
     std::string ip = params.Get("ip").As<Napi::String>().Utf8Value();
     int port = params.Get("port").As<Napi::Number>().Int32Value();
     clientID_ = params.Get("clientID").As<Napi::String>().Utf8Value();
+    clientIdValue_ = Napi::Reference<Napi::String>::New(params.Get("clientID").As<Napi::String>(), 1);
     std::string ipReserve = "";
     if (params.Has("ipReserve") && params.Get("ipReserve").IsString()) {
         ipReserve = params.Get("ipReserve").As<Napi::String>().Utf8Value();
@@ -189,166 +892,110 @@ Napi::Value MmsClient::Connect(const Napi::CallbackInfo& info) {
         reconnectDelay = params.Get("reconnectDelay").As<Napi::Number>().Int32Value();
     }
 
-    if (ip.empty() || port <= 0 || clientID_.empty()) {
-        Napi::Error::New(env, "Invalid 'ip', 'port', or 'clientID'").ThrowAsJavaScriptException();
+    pipeline_ = false;
+    if (params.Has("pipeline") && params.Get("pipeline").IsBoolean()) {
+        pipeline_ = params.Get("pipeline").As<Napi::Boolean>().Value();
+    }
+    requestedWindow_ = 10;
+    if (params.Has("maxOutstanding") && params.Get("maxOutstanding").IsNumber()) {
+        requestedWindow_ = params.Get("maxOutstanding").As<Napi::Number>().Int32Value();
+    }
+    windowLimit_ = requestedWindow_;
+    pipelineWindow_ = requestedWindow_;
+
+    int64_t requestTimeout = 0;
+    if (params.Has("requestTimeout") && params.Get("requestTimeout").IsNumber()) {
+        requestTimeout = params.Get("requestTimeout").As<Napi::Number>().Int64Value();
+    }
+
+    threadless_ = false;
+    if (params.Has("threadless") && params.Get("threadless").IsBoolean()) {
+        threadless_ = params.Get("threadless").As<Napi::Boolean>().Value();
+    }
+
+    nodeLoop_ = false;
+    if (params.Has("nodeLoop") && params.Get("nodeLoop").IsBoolean()) {
+        nodeLoop_ = params.Get("nodeLoop").As<Napi::Boolean>().Value();
+    }
+    if (nodeLoop_) {
+        threadless_ = true;
+    }
+
+    if (requestedWindow_ < 1) {
+        Napi::RangeError::New(env, "'maxOutstanding' must be at least 1").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    {
-        std::lock_guard<std::mutex> lock(connMutex_);
-        if (running_) {
-            Napi::Error::New(env, "Client already running").ThrowAsJavaScriptException();
-            return env.Undefined();
-        }
+    if (ip.empty() || port <= 0 || clientID_.empty()) {
+        Napi::Error::New(env, "Invalid 'ip', 'port', or 'clientID'").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
 
     try {
         printf("Creating connection to %s:%d, clientID: %s\n", ip.c_str(), port, clientID_.c_str());
         running_ = true;
         usingPrimaryIp_ = true;
+        ip_ = ip;
+        ipReserve_ = ipReserve;
+        port_ = port;
+        reconnectDelay_ = reconnectDelay;
+        currentIp_ = ip;
+        isPrimary_ = true;
+        primaryRetryCount_ = 0;
+        reserveRetryCount_ = 0;
+        nextPrimaryProbe_ = std::chrono::steady_clock::now();
+
+        if (connection_) {
+            IedConnection_destroy(connection_);
+        }
+        connection_ = threadless_ ? IedConnection_createEx(nullptr, false) : IedConnection_create();
+        if (requestTimeout > 0) {
+            IedConnection_setRequestTimeout(connection_, static_cast<uint32_t>(requestTimeout));
+        }
+        requestTimeout_ = IedConnection_getRequestTimeout(connection_);
+        IedConnection_installStateChangedHandler(connection_, ConnectionHandler, this);
+        if (pipeline_) {
+            // Negotiated at association time, so it has to be set before connecting
+            IedConnection_setMaxOutstandingCalls(connection_, requestedWindow_, requestedWindow_);
+        }
 
-        ConnectionHandlerContext* context = new ConnectionHandlerContext{this, &connMutex_};
-        IedConnection_installStateChangedHandler(connection_, ConnectionHandler, context);
-
-        thread_ = std::thread([this, ip, ipReserve, port, reconnectDelay, context]() {
-            int primaryRetryCount = 0;
-            int reserveRetryCount = 0;
-            const int maxRetries = 3;
-            std::string currentIp = ip;
-            bool isPrimary = true;
+        if (threadless_) {
+            connecting_ = false;
+            nextAttempt_ = std::chrono::steady_clock::now();
+            // In node loop mode the shared loop only lends its workers for the blocking requests
+            ConnectionLoop::Instance().Add(this, !nodeLoop_);
+            if (nodeLoop_) {
+                StartNodeLoop(env);
+            }
+        } else {
+            ioThread_ = std::thread(&MmsClient::IoLoop, this);
+        }
 
-            while (running_) {
-                printf("Attempting to connect to %s:%d (attempt %d/%d), clientID: %s\n",
-                       currentIp.c_str(), port, (isPrimary ? primaryRetryCount : reserveRetryCount) + 1, maxRetries, clientID_.c_str());
-                IedClientError error;
-                IedConnection_connect(connection_, &error, currentIp.c_str(), port);
-
-                {
-                    std::lock_guard<std::mutex> lock(connMutex_);
-                    connected_ = (error == IED_ERROR_OK);
-                    usingPrimaryIp_ = isPrimary;
-                }
-
-                if (connected_) {
-                    printf("Connected successfully to %s:%d, clientID: %s\n", currentIp.c_str(), port, clientID_.c_str());
-                    primaryRetryCount = 0;
-                    reserveRetryCount = 0;
-                    tsfn_.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
-                        if (env.IsExceptionPending()) {
-                            printf("Connect: Exception pending in env, clientID: %s\n", clientID_.c_str());
-                            return;
-                        }
-                        Napi::Object eventObj = Napi::Object::New(env);
-                        eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                        eventObj.Set("type", Napi::String::New(env, "control"));
-                        eventObj.Set("event", Napi::String::New(env, "opened"));
-                        eventObj.Set("reason", Napi::String::New(env, "connection established"));
-                        eventObj.Set("isPrimaryIP", Napi::Boolean::New(env, usingPrimaryIp_));
-                        jsCallback.Call({Napi::String::New(env, "conn"), eventObj});
-                    });
-
-                    while (running_) {
-                        {
-                            std::lock_guard<std::mutex> lock(connMutex_);
-                            if (!connected_ || !running_) break;
-                        }
-
-                        if (!isPrimary && !ipReserve.empty()) {
-                            IedConnection testConn = IedConnection_create();
-                            IedClientError testError;
-                            IedConnection_connect(testConn, &testError, ip.c_str(), port);
-                            if (testError == IED_ERROR_OK) {
-                                IedConnection_close(testConn);
-                                IedConnection_destroy(testConn);
-                                printf("Switching back to primary IP %s, clientID: %s\n", ip.c_str(), clientID_.c_str());
-                                currentIp = ip;
-                                isPrimary = true;
-                                IedConnection_close(connection_);
-                                {
-                                    std::lock_guard<std::mutex> lock(connMutex_);
-                                    connected_ = false;
-                                }
-                                break;
-                            }
-                            IedConnection_destroy(testConn);
-                        }
-
-                        std::this_thread::sleep_for(std::chrono::seconds(1));
-                    }
-                } else {
-                    printf("Connection failed to %s:%d, error: %d, clientID: %s\n", currentIp.c_str(), port, error, clientID_.c_str());
-                    tsfn_.NonBlockingCall([this, currentIp, isPrimary, retryCount = (isPrimary ? primaryRetryCount : reserveRetryCount)](Napi::Env env, Napi::Function jsCallback) {
-                        if (env.IsExceptionPending()) {
-                            printf("Connect: Exception pending in env, clientID: %s\n", clientID_.c_str());
-                            return;
-                        }
-                        Napi::Object eventObj = Napi::Object::New(env);
-                        eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                        eventObj.Set("type", Napi::String::New(env, "control"));
-                        eventObj.Set("event", Napi::String::New(env, "reconnecting"));
-                        eventObj.Set("reason", Napi::String::New(env, std::string("attempt ") + std::to_string(retryCount + 1) + " to " + currentIp));
-                        eventObj.Set("isPrimaryIP", Napi::Boolean::New(env, isPrimary));
-                        std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-                        jsCallback.Call(args);
-                    });
-
-                    if (isPrimary) {
-                        primaryRetryCount++;
-                    } else {
-                        reserveRetryCount++;
-                    }
-
-                    if (isPrimary && primaryRetryCount >= maxRetries && !ipReserve.empty()) {
-                        printf("Primary IP %s unresponsive after %d attempts, switching to reserve IP %s, clientID: %s\n",
-                               ip.c_str(), maxRetries, ipReserve.c_str(), clientID_.c_str());
-                        currentIp = ipReserve;
-                        isPrimary = false;
-                        primaryRetryCount = 0;
-                        reserveRetryCount = 0;
-                    } else if (!isPrimary && reserveRetryCount >= maxRetries) {
-                        printf("Reserve IP %s unresponsive after %d attempts, switching back to primary IP %s, clientID: %s\n",
-                               ipReserve.c_str(), maxRetries, ip.c_str(), clientID_.c_str());
-                        currentIp = ip;
-                        isPrimary = true;
-                        reserveRetryCount = 0;
-                        primaryRetryCount = 0;
-                    }
-
-                    printf("Reconnection attempt failed, retrying in %d seconds, clientID: %s\n", reconnectDelay, clientID_.c_str());
-                    std::this_thread::sleep_for(std::chrono::seconds(reconnectDelay));
-                }
-
-                if (!running_ && connected_) {
-                    printf("Thread stopped by client, closing connection, clientID: %s\n", clientID_.c_str());
-                    IedConnection_close(connection_);
-                    {
-                        std::lock_guard<std::mutex> lock(connMutex_);
-                        connected_ = false;
-                    }
-                    delete context;
-                    return;
-                }
-            }
-            delete context;
-        });
-
-        return env.Undefined();
+        if (reply) {
+            // Resolves once the connection is being established; its progress is reported by the connection events
+            reply->settled = true;
+            reply->deferred.Resolve(env.Undefined());
+        }
+        return ReplyValue(env, reply);
     } catch (const std::exception& e) {
         printf("Exception in Connect: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
+        tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
             if (env.IsExceptionPending()) {
                 printf("Connect: Exception pending in env, clientID: %s\n", clientID_.c_str());
                 return;
             }
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Thread exception: ") + e.what()));
-            std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+            eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Thread exception: ") + e.what()));
+            if (Settle(reply, env, eventObj)) {
+                return;
+            }
+            std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
             jsCallback.Call(args);
         });
         running_ = false;
-        return env.Undefined();
+        return ReplyValue(env, reply);
     }
 }
 
@@ -359,144 +1006,177 @@ Napi::Value MmsClient::ReadDataSetValues(const Napi::CallbackInfo& info) {
         return env.Undefined();
     }
     std::string datasetRef = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(connMutex_);
+    ReplyPtr reply = NewReply(env);
+    CallOptions options = ParseCallOptions(env, info[1]);
     if (!connected_) {
         printf("ReadDataSetValues: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+        return Fail(env, reply, "Not connected");
     }
-    try {
+    Post(CommandQueue::LANE_POLLING, [this, options, reply, datasetRef]() {
+        if (!connected_) {
+            printf("ReadDataSetValues: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+        if (options.Aborted()) {
+            EmitAborted(reply, "ReadDataSetValues");
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+        if (pipeline_) {
+            SubmitPipelined([this, datasetRef, reply, options]() {
+                if (options.Aborted()) {
+                    inFlight_--;
+                    EmitAborted(reply, "ReadDataSetValues");
+                    return;
+                }
+                RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+                PendingDataSetRead* read = new PendingDataSetRead{this, datasetRef, reply};
+                IedClientError error;
+                IedConnection_readDataSetValuesAsync(connection_, &error, datasetRef.c_str(), nullptr, ReadDataSetHandler, read);
+                if (error != IED_ERROR_OK) {
+                    ReadDataSetHandler(0, read, error, nullptr);
+                }
+            });
+            return;
+        }
         IedClientError error;
         ClientDataSet dataSet = IedConnection_readDataSetValues(connection_, &error, datasetRef.c_str(), nullptr);
-       if (error != IED_ERROR_OK || dataSet == nullptr) {
+        CompleteDataSetRead(datasetRef, dataSet, error, reply);
+    });
+    return ReplyValue(env, reply);
+}
+
+// Emits the values of a dataset read, or the read error. Runs on the I/O thread for both the
+// blocking and the pipelined path and takes ownership of dataSet.
+void MmsClient::CompleteDataSetRead(const std::string& datasetRef, ClientDataSet dataSet, IedClientError error, ReplyPtr reply) {
+    try {
+        if (error != IED_ERROR_OK || dataSet == nullptr) {
             printf("Failed to read dataset %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
             std::string errorMsg = "Failed to read dataset: " + std::to_string(error);
-            tsfn_.NonBlockingCall([this, datasetRef, errorMsg](Napi::Env env, Napi::Function jsCallback) {
+            tsfn_.NonBlockingCall([this, reply, datasetRef, errorMsg](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, errorMsg));
-                eventObj.Set("datasetRef", Napi::String::New(env, datasetRef)); // Add datasetRef
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, errorMsg));
+                eventObj.Set(EventKeys::Get(env, KEY_DATASET_REF), Napi::String::New(env, datasetRef)); // Add datasetRef
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            if (dataSet != nullptr) {
+                ClientDataSet_destroy(dataSet);
+            }
+            return;
         }
         MmsValue* values = ClientDataSet_getValues(dataSet);
         if (values == nullptr) {
             printf("No values in dataset %s, clientID: %s\n", datasetRef.c_str(), clientID_.c_str());
             ClientDataSet_destroy(dataSet);
-            return env.Undefined();
+            if (reply) {
+                tsfn_.NonBlockingCall([this, reply, datasetRef](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "No values in dataset " + datasetRef));
+                    Settle(reply, env, eventObj);
+                });
+            }
+            return;
         }
-        std::function<ResultData(MmsValue*, const std::string&)> convertMmsValue;
-        convertMmsValue = [&](MmsValue* val, const std::string& attrName) -> ResultData {
-            ResultData data = { MmsValue_getType(val), 0.0f, 0, false, "", {}, {}, true, "" };
-            switch (data.type) {
-                case MMS_FLOAT:
-                    data.floatValue = MmsValue_toFloat(val);
-                    if (std::isnan(data.floatValue) || std::isinf(data.floatValue)) {
-                        data.isValid = false;
-                        data.errorReason = "Invalid float value";
-                    }
-                    break;
-                case MMS_INTEGER:
-                    data.intValue = MmsValue_toInt32(val);
-                    break;
-                case MMS_BOOLEAN:
-                    data.boolValue = MmsValue_getBoolean(val);
-                    break;
-                case MMS_VISIBLE_STRING:
-                    data.stringValue = MmsValue_toString(val) ? MmsValue_toString(val) : "";
-                    break;
-                case MMS_UTC_TIME: {
-                    uint64_t timestamp = MmsValue_getUtcTimeInMs(val);
-                    time_t time = timestamp / 1000;
-                    char timeStr[64];
-                    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", gmtime(&time));
-                    data.stringValue = std::string(timeStr) + "." + std::to_string(timestamp % 1000);
-                    } break;
-                case MMS_BIT_STRING: {
-                    int bitSize = MmsValue_getBitStringSize(val);
-                    char bitStr[128];
-                    snprintf(bitStr, sizeof(bitStr), "BitString(size=%d)", bitSize);
-                    data.stringValue = bitStr;
-                    } break;
-                case MMS_STRUCTURE: {
-                    int size = MmsValue_getArraySize(val);
-                    for (int j = 0; j < size; j++) {
-                        MmsValue* element = MmsValue_getElement(val, j);
-                        if (element) {
-                            std::string subAttrName = attrName + ".field" + std::to_string(j);
-                            ResultData subData = convertMmsValue(element, subAttrName);
-                            if (subData.isValid) data.structureElements.push_back(subData);
-                        }
-                    }
-                    } break;
-                case MMS_ARRAY: {
-                    int size = MmsValue_getArraySize(val);
-                    for (int j = 0; j < size; j++) {
-                        MmsValue* element = MmsValue_getElement(val, j);
-                        if (element) {
-                            ResultData subData = convertMmsValue(element, attrName + "[" + std::to_string(j) + "]");
-                            data.arrayElements.push_back(subData);
-                        }
-                    }
-                    } break;
-                case MMS_DATA_ACCESS_ERROR:
-                    data.isValid = false;
-                    data.errorReason = "Data access error";
-                    break;
-                default:
-                    data.isValid = false;
-                    data.errorReason = "Unsupported type: " + std::to_string(data.type);
-            }
-            return data;
-        };
-        ResultData resultData = convertMmsValue(values, datasetRef);
-        tsfn_.NonBlockingCall([this, datasetRef, resultData](Napi::Env env, Napi::Function jsCallback) {
+        if (format_ == ValueFormat::Columnar && MmsValue_getType(values) == MMS_ARRAY) {
+            uint32_t size = MmsValue_getArraySize(values);
+            auto columns = std::make_shared<ColumnarMmsValues>(size, convert_.timestamps);
+            for (uint32_t i = 0; i < size; i++) {
+                MmsValue* member = MmsValue_getElement(values, i);
+                if (member) columns->Set(i, member);
+            }
+            ClientDataSet_destroy(dataSet);
+            tsfn_.NonBlockingCall([this, reply, datasetRef, columns](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_DATASET));
+                eventObj.Set(EventKeys::Get(env, KEY_DATASET_REF), Napi::String::New(env, datasetRef));
+                eventObj.Set(EventKeys::Get(env, KEY_COLUMNS), columns->ToNapi(env, false));
+                eventObj.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, true));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+        if (format_ == ValueFormat::Binary && MmsValue_getType(values) == MMS_ARRAY) {
+            uint32_t size = MmsValue_getArraySize(values);
+            auto payload = std::make_shared<BinaryMmsValues>(size, false);
+            for (uint32_t i = 0; i < size; i++) {
+                MmsValue* member = MmsValue_getElement(values, i);
+                if (member) payload->Set(i, member);
+            }
+            ClientDataSet_destroy(dataSet);
+            tsfn_.NonBlockingCall([this, reply, datasetRef, payload](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_DATASET));
+                eventObj.Set(EventKeys::Get(env, KEY_DATASET_REF), Napi::String::New(env, datasetRef));
+                eventObj.Set(EventKeys::Get(env, KEY_PAYLOAD), payload->ToNapi(env));
+                eventObj.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, true));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+        auto resultData = std::make_shared<FlatMmsValue>(convert_);
+        if (namedFields_) {
+            // The data set is an array of its members; each member gets its own names
+            auto memberNames = std::make_shared<FieldNames>();
+            memberNames->isArray = true;
+            for (const auto& names : DataSetFieldNames(datasetRef)) {
+                memberNames->children.push_back(names);
+            }
+            resultData->Append(values, ValueHint::None, memberNames);
+        } else {
+            resultData->Append(values);
+        }
+        if (format_ == ValueFormat::Json) {
+            std::string text;
+            JsonWriter json(text);
+            BeginJsonEvent(json, clientID_, EventKeys::Text(KEY_DATASET));
+            json.Key(EventKeys::Text(KEY_DATASET_REF));
+            json.String(datasetRef);
+            json.Key(EventKeys::Text(KEY_VALUE));
+            resultData->WriteJson(json, 0);
+            json.Key(EventKeys::Text(KEY_IS_VALID));
+            json.Bool(resultData->IsValid(0));
+            json.EndObject();
+            ClientDataSet_destroy(dataSet);
+            tsfn_.NonBlockingCall([reply, text = std::move(text)](Napi::Env env, Napi::Function jsCallback) {
+                Napi::String event = Napi::String::New(env, text);
+                if (!Resolve(reply, event)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), event});
+            });
+            return;
+        }
+        tsfn_.NonBlockingCall([this, reply, datasetRef, resultData](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "data"));
-            eventObj.Set("event", Napi::String::New(env, "dataSet"));
-            eventObj.Set("datasetRef", Napi::String::New(env, datasetRef));
-            std::function<Napi::Value(const ResultData&)> toNapiValue = [&](const ResultData& data) -> Napi::Value {
-                if (!data.isValid) return Napi::String::New(env, data.errorReason);
-                switch (data.type) {
-                    case MMS_FLOAT: return Napi::Number::New(env, data.floatValue);
-                    case MMS_INTEGER: return Napi::Number::New(env, data.intValue);
-                    case MMS_BOOLEAN: return Napi::Boolean::New(env, data.boolValue);
-                    case MMS_VISIBLE_STRING: case MMS_UTC_TIME: case MMS_BIT_STRING: return Napi::String::New(env, data.stringValue);
-                    case MMS_STRUCTURE: {
-                        Napi::Object structObj = Napi::Object::New(env);
-                        for (size_t i = 0; i < data.structureElements.size(); i++)
-                            structObj.Set(Napi::String::New(env, "field" + std::to_string(i)), toNapiValue(data.structureElements[i]));
-                        return structObj;
-                    }
-                    case MMS_ARRAY: {
-                        Napi::Array array = Napi::Array::New(env, data.arrayElements.size());
-                        for (size_t i = 0; i < data.arrayElements.size(); i++)
-                            array.Set(uint32_t(i), toNapiValue(data.arrayElements[i]));
-                        return array;
-                    }
-                    default: return Napi::String::New(env, "Unsupported type");
-                }
-            };
-            Napi::Value result = toNapiValue(resultData);
-            eventObj.Set("value", result);
-            eventObj.Set("isValid", Napi::Boolean::New(env, resultData.isValid));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+            eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_DATASET));
+            eventObj.Set(EventKeys::Get(env, KEY_DATASET_REF), Napi::String::New(env, datasetRef));
+            eventObj.Set(EventKeys::Get(env, KEY_VALUE), resultData->ToNapi(env, 0));
+            eventObj.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, resultData->IsValid(0)));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         });
         ClientDataSet_destroy(dataSet);
-        return env.Undefined();
     } catch (const std::exception& e) {
         printf("Exception in ReadDataSetValues: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
+        tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in ReadDataSetValues: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+            eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Exception in ReadDataSetValues: ") + e.what()));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         });
-        return env.Undefined();
     }
 }
 
@@ -504,125 +1184,168 @@ Napi::Value MmsClient::BrowseDataModel(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
 
-    std::lock_guard<std::mutex> lock(connMutex_);
+    CallOptions options = ParseCallOptions(env, info[0]);
     if (!connected_) {
         printf("BrowseDataModel: Not connected, clientID: %s\n", clientID_.c_str());
         deferred.Reject(Napi::Error::New(env, "Not connected").Value());
         return deferred.Promise();
     }
 
-    try {
-        IedClientError error;
-        // Get logical device list
-        LinkedList deviceList = IedConnection_getLogicalDeviceList(connection_, &error);
-        if (error != IED_ERROR_OK || deviceList == nullptr) {
-            printf("BrowseDataModel: Failed to get logical device list, error: %d, clientID: %s\n", error, clientID_.c_str());
-            deferred.Reject(Napi::Error::New(env, "Failed to get logical device list").Value());
-            return deferred.Promise();
-        }
-
-        // Store results
-        Napi::Array resultArray = Napi::Array::New(env);
-        uint32_t deviceIndex = 0;
-
-        LinkedList device = LinkedList_getNext(deviceList);
-        while (device != nullptr) {
-            std::string ldName = (char*)device->data;
-            printf("BrowseDataModel: Logical Device: %s, clientID: %s\n", ldName.c_str(), clientID_.c_str());
-
-            Napi::Object ldObj = Napi::Object::New(env);
-            ldObj.Set("name", Napi::String::New(env, ldName));
-            Napi::Array lnArray = Napi::Array::New(env);
-            uint32_t lnIndex = 0;
-
-            // Get logical nodes
-            LinkedList logicalNodes = IedConnection_getLogicalDeviceDirectory(connection_, &error, ldName.c_str());
-            if (error == IED_ERROR_OK && logicalNodes != nullptr) {
-                LinkedList logicalNode = LinkedList_getNext(logicalNodes);
-                while (logicalNode != nullptr) {
-                    std::string lnName = (char*)logicalNode->data;
-                    printf("BrowseDataModel:   Logical Node: %s/%s, clientID: %s\n", ldName.c_str(), lnName.c_str(), clientID_.c_str());
-
-                    Napi::Object lnObj = Napi::Object::New(env);
-                    lnObj.Set("name", Napi::String::New(env, lnName));
-                    Napi::Array dsArray = Napi::Array::New(env);
-                    uint32_t dsIndex = 0;
-
-                    // Construct logical node reference
-                    std::string lnRef = ldName + "/" + lnName;
-
-                    // Get datasets
-                    LinkedList dataSets = IedConnection_getLogicalNodeDirectory(connection_, &error, lnRef.c_str(), ACSI_CLASS_DATA_SET);
-                    if (error == IED_ERROR_OK && dataSets != nullptr) {
-                        LinkedList dataSet = LinkedList_getNext(dataSets);
-                        while (dataSet != nullptr) {
-                            std::string dsName = (char*)dataSet->data;
-                            bool isDeletable;
-                            std::string dsRef = lnRef + "." + dsName;
-
-                            LinkedList dsMembers = IedConnection_getDataSetDirectory(connection_, &error, dsRef.c_str(), &isDeletable);
-                            if (error == IED_ERROR_OK && dsMembers != nullptr) {
-                                printf("BrowseDataModel:     DataSet: %s (%s), clientID: %s\n", 
-                                       dsRef.c_str(), isDeletable ? "deletable" : "not deletable", clientID_.c_str());
-
-                                Napi::Object dsObj = Napi::Object::New(env);
-                                dsObj.Set("name", Napi::String::New(env, dsName));
-                                dsObj.Set("reference", Napi::String::New(env, dsRef));
-                                dsObj.Set("isDeletable", Napi::Boolean::New(env, isDeletable));
-                                Napi::Array memberArray = Napi::Array::New(env);
-                                uint32_t memberIndex = 0;
-
-                                LinkedList dsMember = LinkedList_getNext(dsMembers);
-                                while (dsMember != nullptr) {
-                                    std::string memberRef = (char*)dsMember->data;
-                                    printf("BrowseDataModel:       Member: %s, clientID: %s\n", memberRef.c_str(), clientID_.c_str());
-                                    memberArray.Set(memberIndex++, Napi::String::New(env, memberRef));
-                                    dsMember = LinkedList_getNext(dsMember);
-                                }
+    Post(CommandQueue::LANE_BROWSE, [this, options, deferred]() {
+        if (!connected_) {
+            printf("BrowseDataModel: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+                deferred.Reject(Napi::Error::New(env, "Not connected").Value());
+            });
+            return;
+        }
+        if (options.Aborted()) {
+            RejectAborted(deferred);
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+
+        try {
+            IedClientError error;
+            // Get logical device list
+            LinkedList deviceList = IedConnection_getLogicalDeviceList(connection_, &error);
+            if (error != IED_ERROR_OK || deviceList == nullptr) {
+                printf("BrowseDataModel: Failed to get logical device list, error: %d, clientID: %s\n", error, clientID_.c_str());
+                tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+                    deferred.Reject(Napi::Error::New(env, "Failed to get logical device list").Value());
+                });
+                return;
+            }
+
+            // Store results
+            std::vector<LogicalDeviceInfo> devices;
+
+            LinkedList device = LinkedList_getNext(deviceList);
+            while (device != nullptr) {
+                std::string ldName = (char*)device->data;
+                printf("BrowseDataModel: Logical Device: %s, clientID: %s\n", ldName.c_str(), clientID_.c_str());
+
+                LogicalDeviceInfo ldInfo;
+                ldInfo.name = ldName;
+
+                // Get logical nodes
+                LinkedList logicalNodes = IedConnection_getLogicalDeviceDirectory(connection_, &error, ldName.c_str());
+                if (error == IED_ERROR_OK && logicalNodes != nullptr) {
+                    LinkedList logicalNode = LinkedList_getNext(logicalNodes);
+                    while (logicalNode != nullptr) {
+                        std::string lnName = (char*)logicalNode->data;
+                        printf("BrowseDataModel:   Logical Node: %s/%s, clientID: %s\n", ldName.c_str(), lnName.c_str(), clientID_.c_str());
+
+                        LogicalNodeInfo lnInfo;
+                        lnInfo.name = lnName;
+
+                        // Construct logical node reference
+                        std::string lnRef = ldName + "/" + lnName;
+
+                        // Get datasets
+                        LinkedList dataSets = IedConnection_getLogicalNodeDirectory(connection_, &error, lnRef.c_str(), ACSI_CLASS_DATA_SET);
+                        if (error == IED_ERROR_OK && dataSets != nullptr) {
+                            LinkedList dataSet = LinkedList_getNext(dataSets);
+                            while (dataSet != nullptr) {
+                                std::string dsName = (char*)dataSet->data;
+                                bool isDeletable;
+                                std::string dsRef = lnRef + "." + dsName;
+
+                                LinkedList dsMembers = IedConnection_getDataSetDirectory(connection_, &error, dsRef.c_str(), &isDeletable);
+                                if (error == IED_ERROR_OK && dsMembers != nullptr) {
+                                    printf("BrowseDataModel:     DataSet: %s (%s), clientID: %s\n", 
+                                           dsRef.c_str(), isDeletable ? "deletable" : "not deletable", clientID_.c_str());
+
+                                    DataSetInfo dsInfo;
+                                    dsInfo.name = dsName;
+                                    dsInfo.reference = dsRef;
+                                    dsInfo.isDeletable = isDeletable;
+
+                                    LinkedList dsMember = LinkedList_getNext(dsMembers);
+                                    while (dsMember != nullptr) {
+                                        std::string memberRef = (char*)dsMember->data;
+                                        printf("BrowseDataModel:       Member: %s, clientID: %s\n", memberRef.c_str(), clientID_.c_str());
+                                        dsInfo.members.push_back(memberRef);
+                                        RememberMemberFc(memberRef);
+                                        dsMember = LinkedList_getNext(dsMember);
+                                    }
 
-                                dsObj.Set("members", memberArray);
-                                dsArray.Set(dsIndex++, dsObj);
-                                LinkedList_destroy(dsMembers);
-                            } else {
-                                printf("BrowseDataModel:     Failed to get dataset directory for %s, error: %d, clientID: %s\n", 
-                                       dsRef.c_str(), error, clientID_.c_str());
+                                    lnInfo.dataSets.push_back(std::move(dsInfo));
+                                    LinkedList_destroy(dsMembers);
+                                } else {
+                                    printf("BrowseDataModel:     Failed to get dataset directory for %s, error: %d, clientID: %s\n", 
+                                           dsRef.c_str(), error, clientID_.c_str());
+                                }
+                                dataSet = LinkedList_getNext(dataSet);
                             }
-                            dataSet = LinkedList_getNext(dataSet);
+                            LinkedList_destroy(dataSets);
                         }
-                        LinkedList_destroy(dataSets);
-                    }
 
-                    lnObj.Set("dataSets", dsArray);
-                    lnArray.Set(lnIndex++, lnObj);
-                    logicalNode = LinkedList_getNext(logicalNode);
+                        ldInfo.logicalNodes.push_back(std::move(lnInfo));
+                        logicalNode = LinkedList_getNext(logicalNode);
+                    }
+                    LinkedList_destroy(logicalNodes);
                 }
-                LinkedList_destroy(logicalNodes);
+
+                devices.push_back(std::move(ldInfo));
+                device = LinkedList_getNext(device);
             }
+            LinkedList_destroy(deviceList);
+
+            // Build the JS model, emit event with results and resolve
+            tsfn_.NonBlockingCall([this, devices, deferred](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Array resultArray = Napi::Array::New(env, devices.size());
+                for (size_t d = 0; d < devices.size(); d++) {
+                    Napi::Object ldObj = Napi::Object::New(env);
+                    ldObj.Set(EventKeys::Get(env, KEY_NAME), Napi::String::New(env, devices[d].name));
+                    Napi::Array lnArray = Napi::Array::New(env, devices[d].logicalNodes.size());
+                    for (size_t l = 0; l < devices[d].logicalNodes.size(); l++) {
+                        const LogicalNodeInfo& lnInfo = devices[d].logicalNodes[l];
+                        Napi::Object lnObj = Napi::Object::New(env);
+                        lnObj.Set(EventKeys::Get(env, KEY_NAME), Napi::String::New(env, lnInfo.name));
+                        Napi::Array dsArray = Napi::Array::New(env, lnInfo.dataSets.size());
+                        for (size_t i = 0; i < lnInfo.dataSets.size(); i++) {
+                            const DataSetInfo& dsInfo = lnInfo.dataSets[i];
+                            Napi::Object dsObj = Napi::Object::New(env);
+                            dsObj.Set(EventKeys::Get(env, KEY_NAME), Napi::String::New(env, dsInfo.name));
+                            dsObj.Set("reference", Napi::String::New(env, dsInfo.reference));
+                            dsObj.Set("isDeletable", Napi::Boolean::New(env, dsInfo.isDeletable));
+                            Napi::Array memberArray = Napi::Array::New(env, dsInfo.members.size());
+                            for (size_t m = 0; m < dsInfo.members.size(); m++) {
+                                memberArray.Set(uint32_t(m), Napi::String::New(env, dsInfo.members[m]));
+                            }
+                            dsObj.Set("members", memberArray);
+                            dsArray.Set(uint32_t(i), dsObj);
+                        }
+                        lnObj.Set("dataSets", dsArray);
+                        lnArray.Set(uint32_t(l), lnObj);
+                    }
+                    ldObj.Set("logicalNodes", lnArray);
+                    resultArray.Set(uint32_t(d), ldObj);
+                }
 
-            ldObj.Set("logicalNodes", lnArray);
-            resultArray.Set(deviceIndex++, ldObj);
-            device = LinkedList_getNext(device);
-        }
-        LinkedList_destroy(deviceList);
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                    eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "dataModel"));
+                    eventObj.Set("dataModel", resultArray);
+                    jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                }
 
-        // Emit event with results
-        tsfn_.NonBlockingCall([this, resultArray](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "data"));
-            eventObj.Set("event", Napi::String::New(env, "dataModel"));
-            eventObj.Set("dataModel", resultArray);
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
+                deferred.Resolve(resultArray);
+            });
 
-        deferred.Resolve(resultArray);
-        return deferred.Promise();
+        } catch (const std::exception& e) {
+            printf("BrowseDataModel: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            std::string reason = std::string("Exception in BrowseDataModel: ") + e.what();
+            tsfn_.NonBlockingCall([deferred, reason](Napi::Env env, Napi::Function jsCallback) {
+                deferred.Reject(Napi::Error::New(env, reason).Value());
+            });
+        }
+    });
 
-    } catch (const std::exception& e) {
-        printf("BrowseDataModel: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        deferred.Reject(Napi::Error::New(env, std::string("Exception in BrowseDataModel: ") + e.what()).Value());
-        return deferred.Promise();
-    }
+    return deferred.Promise();
 }
 
 Napi::Value MmsClient::CreateDataSet(const Napi::CallbackInfo& info) {
@@ -632,56 +1355,72 @@ Napi::Value MmsClient::CreateDataSet(const Napi::CallbackInfo& info) {
         return env.Undefined();
     }
     std::string datasetRef = info[0].As<Napi::String>().Utf8Value();
-    Napi::Array elements = info[1].As<Napi::Array>();
-    std::lock_guard<std::mutex> lock(connMutex_);
+    Napi::Array elementsArray = info[1].As<Napi::Array>();
+    std::vector<std::string> elements;
+    for (uint32_t i = 0; i < elementsArray.Length(); i++) {
+        if (elementsArray.Get(i).IsString()) {
+            elements.push_back(elementsArray.Get(i).As<Napi::String>().Utf8Value());
+        }
+    }
+    ReplyPtr reply = NewReply(env);
     if (!connected_) {
         printf("CreateDataSet: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+        return Fail(env, reply, "Not connected");
     }
-    try {
-        LinkedList dataSetItems = LinkedList_create();
-        for (uint32_t i = 0; i < elements.Length(); i++) {
-            if (elements.Get(i).IsString()) {
-                std::string element = elements.Get(i).As<Napi::String>().Utf8Value();
+    Post(CommandQueue::LANE_REPORTS, [this, reply, datasetRef, elements]() {
+        if (!connected_) {
+            printf("CreateDataSet: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+        try {
+            LinkedList dataSetItems = LinkedList_create();
+            for (const auto& element : elements) {
                 LinkedList_add(dataSetItems, strdup(element.c_str()));
             }
-        }
-        IedClientError error;
-        IedConnection_createDataSet(connection_, &error, datasetRef.c_str(), dataSetItems);
-        LinkedList_destroyDeep(dataSetItems, free);
-        if (error != IED_ERROR_OK) {
-            printf("Failed to create dataset %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
-            std::string errorMsg = "Failed to create dataset: " + std::to_string(error);
-            tsfn_.NonBlockingCall([this, errorMsg](Napi::Env env, Napi::Function jsCallback) {
+            IedClientError error;
+            IedConnection_createDataSet(connection_, &error, datasetRef.c_str(), dataSetItems);
+            LinkedList_destroyDeep(dataSetItems, free);
+            if (error != IED_ERROR_OK) {
+                printf("Failed to create dataset %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
+                std::string errorMsg = "Failed to create dataset: " + std::to_string(error);
+                tsfn_.NonBlockingCall([this, reply, errorMsg](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, errorMsg));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                });
+                return;
+            }
+            tsfn_.NonBlockingCall([this, reply, datasetRef](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, errorMsg));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+                eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "dataSetCreated"));
+                eventObj.Set(EventKeys::Get(env, KEY_DATASET_REF), Napi::String::New(env, datasetRef));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
+        } catch (const std::exception& e) {
+            printf("Exception in CreateDataSet: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Exception in CreateDataSet: ") + e.what()));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
         }
-        tsfn_.NonBlockingCall([this, datasetRef](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "control"));
-            eventObj.Set("event", Napi::String::New(env, "dataSetCreated"));
-            eventObj.Set("datasetRef", Napi::String::New(env, datasetRef));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
-        return env.Undefined();
-    } catch (const std::exception& e) {
-        printf("Exception in CreateDataSet: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in CreateDataSet: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
-        return env.Undefined();
-    }
+    });
+    return ReplyValue(env, reply);
 }
 
 Napi::Value MmsClient::DeleteDataSet(const Napi::CallbackInfo& info) {
@@ -691,47 +1430,60 @@ Napi::Value MmsClient::DeleteDataSet(const Napi::CallbackInfo& info) {
         return env.Undefined();
     }
     std::string datasetRef = info[0].As<Napi::String>().Utf8Value();
-    std::lock_guard<std::mutex> lock(connMutex_);
+    ReplyPtr reply = NewReply(env);
     if (!connected_) {
         printf("DeleteDataSet: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+        return Fail(env, reply, "Not connected");
     }
-    try {
-        IedClientError error;
-        IedConnection_deleteDataSet(connection_, &error, datasetRef.c_str());
-        if (error != IED_ERROR_OK) {
-            printf("Failed to delete dataset %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
-            std::string errorMsg = "Failed to delete dataset: " + std::to_string(error);
-            tsfn_.NonBlockingCall([this, errorMsg](Napi::Env env, Napi::Function jsCallback) {
+    Post(CommandQueue::LANE_REPORTS, [this, reply, datasetRef]() {
+        if (!connected_) {
+            printf("DeleteDataSet: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, errorMsg));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
         }
-        tsfn_.NonBlockingCall([this, datasetRef](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "control"));
-            eventObj.Set("event", Napi::String::New(env, "dataSetDeleted"));
-            eventObj.Set("datasetRef", Napi::String::New(env, datasetRef));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
-        return env.Undefined();
-    } catch (const std::exception& e) {
-        printf("Exception in DeleteDataSet: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in DeleteDataSet: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
-        return env.Undefined();
-    }
+        try {
+            IedClientError error;
+            IedConnection_deleteDataSet(connection_, &error, datasetRef.c_str());
+            if (error != IED_ERROR_OK) {
+                printf("Failed to delete dataset %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
+                std::string errorMsg = "Failed to delete dataset: " + std::to_string(error);
+                tsfn_.NonBlockingCall([this, reply, errorMsg](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, errorMsg));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                });
+                return;
+            }
+            tsfn_.NonBlockingCall([this, reply, datasetRef](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+                eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "dataSetDeleted"));
+                eventObj.Set(EventKeys::Get(env, KEY_DATASET_REF), Napi::String::New(env, datasetRef));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        } catch (const std::exception& e) {
+            printf("Exception in DeleteDataSet: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Exception in DeleteDataSet: ") + e.what()));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+    });
+    return ReplyValue(env, reply);
 }
 
 Napi::Value MmsClient::GetDataSetDirectory(const Napi::CallbackInfo& info) {
@@ -749,135 +1501,349 @@ Napi::Value MmsClient::GetDataSetDirectory(const Napi::CallbackInfo& info) {
     printf("GetDataSetDirectory: Attempting to retrieve datasets for %s, clientID: %s\n", 
            logicalNodeRef.c_str(), clientID_.c_str());
 
-    std::lock_guard<std::mutex> lock(connMutex_);
+    CallOptions options = ParseCallOptions(env, info[1]);
     if (!connected_) {
         printf("GetDataSetDirectory: Not connected, clientID: %s\n", clientID_.c_str());
         deferred.Reject(Napi::Error::New(env, "Not connected").Value());
         return deferred.Promise();
     }
 
-    try {
-        IedClientError error;
-        // Retrieve dataset directory for the logical node
-        LinkedList dataSetList = IedConnection_getDataSetDirectory(connection_, &error, logicalNodeRef.c_str(), nullptr);
-
-        if (error != IED_ERROR_OK || dataSetList == nullptr) {
-            printf("GetDataSetDirectory: Failed to get dataset directory for %s, error: %d, clientID: %s\n", 
-                   logicalNodeRef.c_str(), error, clientID_.c_str());
-            tsfn_.NonBlockingCall([this, logicalNodeRef, error](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to get dataset directory for " + logicalNodeRef + ", error: " + std::to_string(error)));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+    Post(CommandQueue::LANE_BROWSE, [this, options, logicalNodeRef, deferred]() {
+        if (!connected_) {
+            printf("GetDataSetDirectory: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+                deferred.Reject(Napi::Error::New(env, "Not connected").Value());
             });
-            deferred.Reject(Napi::Error::New(env, "Failed to get dataset directory, error: " + std::to_string(error)).Value());
-            return deferred.Promise();
-        }
-  
-        // Collect dataset references
-        std::vector<std::string> dataSets;
-        LinkedList current = dataSetList;
-        while (current != nullptr) {
-            if (current->data != nullptr) {
-                char* dataSetName = (char*)current->data;
-                dataSets.push_back(std::string(dataSetName));
-                printf("GetDataSetDirectory: Found dataset: %s/%s, clientID: %s\n", 
-                       logicalNodeRef.c_str(), dataSetName, clientID_.c_str());
-            }
-            current = LinkedList_getNext(current);
-        }
-        LinkedList_destroy(dataSetList);
-
-        // Send event via TSFN
-        tsfn_.NonBlockingCall([this, logicalNodeRef, dataSets](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "data"));
-            eventObj.Set("event", Napi::String::New(env, "dataSetDirectory"));
-            eventObj.Set("logicalNodeRef", Napi::String::New(env, logicalNodeRef));
+            return;
+        }
+        if (options.Aborted()) {
+            RejectAborted(deferred);
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
 
-            Napi::Array dataSetArray = Napi::Array::New(env, dataSets.size());
-            for (size_t i = 0; i < dataSets.size(); ++i) {
-                dataSetArray.Set(uint32_t(i), Napi::String::New(env, dataSets[i]));
+        try {
+            IedClientError error;
+            // Retrieve dataset directory for the logical node
+            LinkedList dataSetList = IedConnection_getDataSetDirectory(connection_, &error, logicalNodeRef.c_str(), nullptr);
+
+            if (error != IED_ERROR_OK || dataSetList == nullptr) {
+                printf("GetDataSetDirectory: Failed to get dataset directory for %s, error: %d, clientID: %s\n", 
+                       logicalNodeRef.c_str(), error, clientID_.c_str());
+                tsfn_.NonBlockingCall([this, logicalNodeRef, error, deferred](Napi::Env env, Napi::Function jsCallback) {
+                    if (!promiseOnly_) {
+                        Napi::Object eventObj = Napi::Object::New(env);
+                        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to get dataset directory for " + logicalNodeRef + ", error: " + std::to_string(error)));
+                        jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                    }
+                    deferred.Reject(Napi::Error::New(env, "Failed to get dataset directory, error: " + std::to_string(error)).Value());
+                });
+                return;
+            }
+      
+            // Collect dataset references
+            std::vector<std::string> dataSets;
+            LinkedList current = dataSetList;
+            while (current != nullptr) {
+                if (current->data != nullptr) {
+                    char* dataSetName = (char*)current->data;
+                    dataSets.push_back(std::string(dataSetName));
+                    printf("GetDataSetDirectory: Found dataset: %s/%s, clientID: %s\n", 
+                           logicalNodeRef.c_str(), dataSetName, clientID_.c_str());
+                }
+                current = LinkedList_getNext(current);
             }
-            eventObj.Set("dataSets", dataSetArray);
+            LinkedList_destroy(dataSetList);
+            printf("GetDataSetDirectory: Successfully retrieved %zu datasets for %s, clientID: %s\n", 
+                   dataSets.size(), logicalNodeRef.c_str(), clientID_.c_str());
 
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
+            // Send event via TSFN and resolve promise with dataset array
+            tsfn_.NonBlockingCall([this, logicalNodeRef, dataSets, deferred](Napi::Env env, Napi::Function jsCallback) {
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                    eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "dataSetDirectory"));
+                    eventObj.Set("logicalNodeRef", Napi::String::New(env, logicalNodeRef));
+
+                    Napi::Array dataSetArray = Napi::Array::New(env, dataSets.size());
+                    for (size_t i = 0; i < dataSets.size(); ++i) {
+                        dataSetArray.Set(uint32_t(i), Napi::String::New(env, dataSets[i]));
+                    }
+                    eventObj.Set("dataSets", dataSetArray);
 
-        // Resolve promise with dataset array
-        Napi::Array resultArray = Napi::Array::New(env, dataSets.size());
-        for (size_t i = 0; i < dataSets.size(); ++i) {
-            resultArray.Set(uint32_t(i), Napi::String::New(env, dataSets[i]));
+                    jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                }
+
+                Napi::Array resultArray = Napi::Array::New(env, dataSets.size());
+                for (size_t i = 0; i < dataSets.size(); ++i) {
+                    resultArray.Set(uint32_t(i), Napi::String::New(env, dataSets[i]));
+                }
+                deferred.Resolve(resultArray);
+            });
+
+        } catch (const std::exception& e) {
+            printf("GetDataSetDirectory: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            std::string reason = std::string("Exception in GetDataSetDirectory: ") + e.what();
+            tsfn_.NonBlockingCall([this, reason, deferred](Napi::Env env, Napi::Function jsCallback) {
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+                    jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                }
+                deferred.Reject(Napi::Error::New(env, reason).Value());
+            });
         }
-        printf("GetDataSetDirectory: Successfully retrieved %zu datasets for %s, clientID: %s\n", 
-               dataSets.size(), logicalNodeRef.c_str(), clientID_.c_str());
-        deferred.Resolve(resultArray);
-        return deferred.Promise();
+    });
 
-    } catch (const std::exception& e) {
-        printf("GetDataSetDirectory: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in GetDataSetDirectory: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
-        deferred.Reject(Napi::Error::New(env, std::string("Exception in GetDataSetDirectory: ") + e.what()).Value());
-        return deferred.Promise();
+    return deferred.Promise();
+}
+
+// Functional constraints tried for a readData reference, the best guess from the name first
+static std::vector<FunctionalConstraint> ReadFcOrder(const std::string& dataRef) {
+    FunctionalConstraint fc = IEC61850_FC_ST;
+    if (dataRef.find(".SPCSO") != std::string::npos) {
+        fc = IEC61850_FC_ST;
+    } else if (dataRef.find(".AnIn") != std::string::npos) {
+        fc = IEC61850_FC_MX;
+    } else if (dataRef.find(".NamPlt") != std::string::npos || dataRef.find(".PhyNam") != std::string::npos) {
+        fc = IEC61850_FC_DC;
+    } else if (dataRef.find(".Mod") != std::string::npos || dataRef.find(".Proxy") != std::string::npos) {
+        fc = IEC61850_FC_ST;
+    } else if (dataRef.find(".Oper") != std::string::npos) {
+        fc = IEC61850_FC_CO;
+    } else if (dataRef.find(".ctlModel") != std::string::npos) {
+        fc = IEC61850_FC_CF;
     }
+    return {
+        fc, IEC61850_FC_ALL, IEC61850_FC_ST, IEC61850_FC_MX,
+        IEC61850_FC_DC, IEC61850_FC_SP, IEC61850_FC_CO, IEC61850_FC_CF
+    };
 }
 
-Napi::Value MmsClient::ReadData(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+// FC order for a reference on this connection: a cached FC from an earlier success comes first,
+// so steady-state reads need a single request. Only used on the I/O thread.
+std::vector<FunctionalConstraint> MmsClient::ResolveFcOrder(const std::string& dataRef) {
+    std::vector<FunctionalConstraint> fcs = ReadFcOrder(dataRef);
+    auto it = fcCache_.find(dataRef);
+    if (it != fcCache_.end()) {
+        fcs.erase(std::remove(fcs.begin(), fcs.end(), it->second), fcs.end());
+        fcs.insert(fcs.begin(), it->second);
+    }
+    return fcs;
+}
 
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Expected dataRef (string)").ThrowAsJavaScriptException();
-        return env.Undefined();
+void MmsClient::RememberFc(const std::string& dataRef, FunctionalConstraint fc) {
+    if (fc == IEC61850_FC_ALL || fc == IEC61850_FC_NONE) {
+        return;
     }
+    fcCache_[dataRef] = fc;
+}
 
-    std::string dataRef = info[0].As<Napi::String>().Utf8Value();
+void MmsClient::ForgetFc(const std::string& dataRef) {
+    fcCache_.erase(dataRef);
+}
 
-    std::lock_guard<std::mutex> lock(connMutex_);
-    if (!connected_) {
-        printf("ReadData: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+// Seeds the cache from a data set member reference of the form "LD/LN.DO.DA[FC]"
+void MmsClient::RememberMemberFc(const std::string& memberRef) {
+    size_t open = memberRef.rfind('[');
+    if (open == std::string::npos || memberRef.back() != ']') {
+        return;
     }
+    std::string fcString = memberRef.substr(open + 1, memberRef.size() - open - 2);
+    RememberFc(memberRef.substr(0, open), FunctionalConstraint_fromString(fcString.c_str()));
+}
 
-    try {
-        IedClientError error;
-        FunctionalConstraint fc = IEC61850_FC_ST;
-        if (dataRef.find(".SPCSO") != std::string::npos) {
-            fc = IEC61850_FC_ST;
-        } else if (dataRef.find(".AnIn") != std::string::npos) {
-            fc = IEC61850_FC_MX;
-        } else if (dataRef.find(".NamPlt") != std::string::npos || dataRef.find(".PhyNam") != std::string::npos) {
-            fc = IEC61850_FC_DC;
-        } else if (dataRef.find(".Mod") != std::string::npos || dataRef.find(".Proxy") != std::string::npos) {
-            fc = IEC61850_FC_ST;
-        } else if (dataRef.find(".Oper") != std::string::npos) {
-            fc = IEC61850_FC_CO;
-        } else if (dataRef.find(".ctlModel") != std::string::npos) {
-            fc = IEC61850_FC_CF;
-        }
-
-        MmsValue* value = nullptr;
-        std::vector<FunctionalConstraint> fcs = {
-            fc, IEC61850_FC_ALL, IEC61850_FC_ST, IEC61850_FC_MX,
-            IEC61850_FC_DC, IEC61850_FC_SP, IEC61850_FC_CO, IEC61850_FC_CF
-        };
-        for (auto tryFc : fcs) {
-            value = IedConnection_readObject(connection_, &error, dataRef.c_str(), tryFc);
-            if (error == IED_ERROR_OK && value != nullptr) {
-                printf("ReadData: Succeeded with FC %d for dataRef %s, clientID: %s\n", tryFc, dataRef.c_str(), clientID_.c_str());
-                break;
-            }
-            printf("ReadData: Failed with FC %d for dataRef %s, error: %d, clientID: %s\n", tryFc, dataRef.c_str(), error, clientID_.c_str());
+std::shared_ptr<const FieldNames> MmsClient::FieldNamesFor(const std::string& dataRef, FunctionalConstraint fc) {
+    std::string key = dataRef + "[" + FunctionalConstraint_toString(fc) + "]";
+    auto it = fieldNamesCache_.find(key);
+    if (it != fieldNamesCache_.end()) {
+        return it->second;
+    }
+    IedClientError error;
+    MmsVariableSpecification* spec = IedConnection_getVariableSpecification(connection_, &error, dataRef.c_str(), fc);
+    std::shared_ptr<const FieldNames> names;
+    if (error == IED_ERROR_OK && spec != nullptr) {
+        names = FieldNames::FromSpecification(spec);
+    } else {
+        printf("Failed to get variable specification for %s, error: %d, clientID: %s\n", key.c_str(), error, clientID_.c_str());
+    }
+    if (spec != nullptr) {
+        MmsVariableSpecification_destroy(spec);
+    }
+    // Failures are cached too and fall back to positional keys until the next reconnect
+    if (error == IED_ERROR_OK || (error != IED_ERROR_NOT_CONNECTED && error != IED_ERROR_CONNECTION_LOST && error != IED_ERROR_TIMEOUT)) {
+        fieldNamesCache_[key] = names;
+    }
+    return names;
+}
+
+std::shared_ptr<const FieldNames> MmsClient::FieldNamesFor(const std::string& dataRef) {
+    auto it = fcCache_.find(dataRef);
+    if (it == fcCache_.end()) {
+        return nullptr;
+    }
+    return FieldNamesFor(dataRef, it->second);
+}
+
+std::shared_ptr<const FieldNames> MmsClient::MemberFieldNames(const std::string& memberRef) {
+    size_t open = memberRef.rfind('[');
+    if (open == std::string::npos || memberRef.back() != ']') {
+        return nullptr;
+    }
+    std::string fcString = memberRef.substr(open + 1, memberRef.size() - open - 2);
+    FunctionalConstraint fc = FunctionalConstraint_fromString(fcString.c_str());
+    if (fc == IEC61850_FC_NONE) {
+        return nullptr;
+    }
+    return FieldNamesFor(memberRef.substr(0, open), fc);
+}
+
+std::vector<std::shared_ptr<const FieldNames>> MmsClient::DataSetFieldNames(const std::string& datasetRef) {
+    auto it = dataSetNamesCache_.find(datasetRef);
+    if (it != dataSetNamesCache_.end()) {
+        return it->second;
+    }
+    std::vector<std::shared_ptr<const FieldNames>> names;
+    IedClientError error;
+    LinkedList directory = IedConnection_getDataSetDirectory(connection_, &error, datasetRef.c_str(), nullptr);
+    if (error != IED_ERROR_OK || directory == nullptr) {
+        printf("Failed to read dataset directory for %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
+        return names;
+    }
+    for (LinkedList member = LinkedList_getNext(directory); member != nullptr; member = LinkedList_getNext(member)) {
+        names.push_back(MemberFieldNames((char*)member->data));
+    }
+    LinkedList_destroy(directory);
+    dataSetNamesCache_[datasetRef] = names;
+    return names;
+}
+
+// The server model may have changed while the association was down
+void MmsClient::ClearModelCaches() {
+    fcCache_.clear();
+    fieldNamesCache_.clear();
+    dataSetNamesCache_.clear();
+}
+
+Napi::Value MmsClient::ReadData(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected dataRef (string)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    std::string dataRef = info[0].As<Napi::String>().Utf8Value();
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+
+    CallOptions options = ParseCallOptions(env, info[1]);
+    if (!connected_) {
+        printf("ReadData: Not connected, clientID: %s\n", clientID_.c_str());
+        deferred.Reject(Napi::Error::New(env, "Not connected").Value());
+        return deferred.Promise();
+    }
+
+    Post(CommandQueue::LANE_POLLING, [this, options, dataRef, deferred]() {
+        if (!connected_) {
+            printf("ReadData: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+                deferred.Reject(Napi::Error::New(env, "Not connected").Value());
+            });
+            return;
+        }
+        if (options.Aborted()) {
+            RejectAborted(deferred);
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+
+        std::vector<FunctionalConstraint> fcs = ResolveFcOrder(dataRef);
+        if (pipeline_) {
+            PendingRead* read = new PendingRead{this, dataRef, fcs, 0, deferred, options};
+            SubmitPipelined([this, read]() { SendPipelinedRead(read); });
+            return;
         }
 
+        IedClientError error = IED_ERROR_OK;
+        MmsValue* value = nullptr;
+        try {
+            for (auto tryFc : fcs) {
+                value = IedConnection_readObject(connection_, &error, dataRef.c_str(), tryFc);
+                if (error == IED_ERROR_OK && value != nullptr) {
+                    printf("ReadData: Succeeded with FC %d for dataRef %s, clientID: %s\n", tryFc, dataRef.c_str(), clientID_.c_str());
+                    RememberFc(dataRef, tryFc);
+                    break;
+                }
+                printf("ReadData: Failed with FC %d for dataRef %s, error: %d, clientID: %s\n", tryFc, dataRef.c_str(), error, clientID_.c_str());
+                if (value != nullptr) {
+                    MmsValue_delete(value);
+                    value = nullptr;
+                }
+                if (tryFc == fcs[0]) {
+                    ForgetFc(dataRef);
+                }
+            }
+
+            if (error == IED_ERROR_OK && value != nullptr) {
+                if (dataRef.find(".SPCSO") != std::string::npos) {
+                    std::string qRef = dataRef.substr(0, dataRef.rfind(".")) + ".q";
+                    std::string tRef = dataRef.substr(0, dataRef.rfind(".")) + ".t";
+                    IedClientError qError, tError;
+                    MmsValue* qValue = IedConnection_readObject(connection_, &qError, qRef.c_str(), IEC61850_FC_ST);
+                    MmsValue* tValue = IedConnection_readObject(connection_, &tError, tRef.c_str(), IEC61850_FC_ST);
+                    if (qError == IED_ERROR_OK && qValue != nullptr) {
+                        printf("ReadData: Quality for %s: %d, clientID: %s\n", qRef.c_str(), MmsValue_getBitStringBit(qValue, 0), clientID_.c_str());
+                        MmsValue_delete(qValue);
+                    } else {
+                        printf("ReadData: Failed to read quality for %s, error: %d, clientID: %s\n", qRef.c_str(), qError, clientID_.c_str());
+                    }
+                    if (tError == IED_ERROR_OK && tValue != nullptr) {
+                        printf("ReadData: Timestamp for %s: %llu ms, clientID: %s\n", tRef.c_str(), MmsValue_getUtcTimeInMs(tValue), clientID_.c_str());
+                        MmsValue_delete(tValue);
+                    } else {
+                        printf("ReadData: Failed to read timestamp for %s, error: %d, clientID: %s\n", tRef.c_str(), tError, clientID_.c_str());
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            printf("Exception in ReadData: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            std::string reason = std::string("Exception in ReadData: ") + e.what();
+            tsfn_.NonBlockingCall([this, reason, deferred](Napi::Env env, Napi::Function jsCallback) {
+                if (env.IsExceptionPending()) {
+                    printf("ReadData: Exception pending in env, clientID: %s\n", clientID_.c_str());
+                    return;
+                }
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+                    std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                    jsCallback.Call(args);
+                }
+                deferred.Reject(Napi::Error::New(env, reason).Value());
+            });
+            if (value != nullptr) {
+                MmsValue_delete(value);
+            }
+            return;
+        }
+
+        CompleteRead(dataRef, value, error, deferred);
+    });
+
+    return deferred.Promise();
+}
+
+// Settles a readData call with the value read, or with the read error. Runs on the I/O thread for
+// both the blocking and the pipelined path and takes ownership of value.
+void MmsClient::CompleteRead(const std::string& dataRef, MmsValue* value, IedClientError error, Napi::Promise::Deferred deferred) {
+    try {
         if (error != IED_ERROR_OK || value == nullptr) {
             printf("Read failed for dataRef: %s, final error: %d, clientID: %s\n", dataRef.c_str(), error, clientID_.c_str());
             std::string errorMsg;
@@ -888,211 +1854,521 @@ Napi::Value MmsClient::ReadData(const Napi::CallbackInfo& info) {
                 case IED_ERROR_OBJECT_ACCESS_UNSUPPORTED: errorMsg = "Object access unsupported"; break;
                 default: errorMsg = "Unknown error: " + std::to_string(error);
             }
-            tsfn_.NonBlockingCall([this, dataRef, errorMsg](Napi::Env env, Napi::Function jsCallback) {
+            if (value != nullptr) {
+                MmsValue_delete(value);
+            }
+            tsfn_.NonBlockingCall([this, dataRef, errorMsg, deferred](Napi::Env env, Napi::Function jsCallback) {
                 if (env.IsExceptionPending()) {
                     printf("ReadData: Exception pending in env, clientID: %s\n", clientID_.c_str());
                     return;
                 }
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Read failed for dataRef: " + dataRef + ": " + errorMsg));
-                std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-                jsCallback.Call(args);
+                std::string reason = "Read failed for dataRef: " + dataRef + ": " + errorMsg;
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+                    std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                    jsCallback.Call(args);
+                }
+                deferred.Reject(Napi::Error::New(env, reason).Value());
             });
-            return env.Undefined();
+            return;
         }
 
-        if (dataRef.find(".SPCSO") != std::string::npos) {
-            std::string qRef = dataRef.substr(0, dataRef.rfind(".")) + ".q";
-            std::string tRef = dataRef.substr(0, dataRef.rfind(".")) + ".t";
-            IedClientError qError, tError;
-            MmsValue* qValue = IedConnection_readObject(connection_, &qError, qRef.c_str(), IEC61850_FC_ST);
-            MmsValue* tValue = IedConnection_readObject(connection_, &tError, tRef.c_str(), IEC61850_FC_ST);
-            if (qError == IED_ERROR_OK && qValue != nullptr) {
-                printf("ReadData: Quality for %s: %d, clientID: %s\n", qRef.c_str(), MmsValue_getBitStringBit(qValue, 0), clientID_.c_str());
-                MmsValue_delete(qValue);
-            } else {
-                printf("ReadData: Failed to read quality for %s, error: %d, clientID: %s\n", qRef.c_str(), qError, clientID_.c_str());
+
+        auto resultData = std::make_shared<FlatMmsValue>(convert_);
+        std::shared_ptr<const FieldNames> names;
+        if (namedFields_ && MmsValue_getType(value) == MMS_STRUCTURE) {
+            names = FieldNamesFor(dataRef);
+        }
+        resultData->Append(value, FlatMmsValue::HintForAttribute(dataRef.substr(dataRef.rfind(".") + 1)), names);
+        MmsValue_delete(value);
+
+        if (format_ == ValueFormat::Json) {
+            // The promise gets the value's text, the event the whole event's text
+            std::string valueText;
+            JsonWriter valueJson(valueText);
+            resultData->WriteJson(valueJson, 0);
+            std::string text;
+            if (!promiseOnly_) {
+                JsonWriter json(text);
+                BeginJsonEvent(json, clientID_, nullptr);
+                json.Key(EventKeys::Text(KEY_DATA_REF));
+                json.String(dataRef);
+                json.Key(EventKeys::Text(KEY_VALUE));
+                json.Raw(valueText);
+                json.Key(EventKeys::Text(KEY_IS_VALID));
+                json.Bool(resultData->IsValid(0));
+                json.EndObject();
             }
-            if (tError == IED_ERROR_OK && tValue != nullptr) {
-                printf("ReadData: Timestamp for %s: %llu ms, clientID: %s\n", tRef.c_str(), MmsValue_getUtcTimeInMs(tValue), clientID_.c_str());
-                MmsValue_delete(tValue);
-            } else {
-                printf("ReadData: Failed to read timestamp for %s, error: %d, clientID: %s\n", tRef.c_str(), tError, clientID_.c_str());
+            tsfn_.NonBlockingCall([this, valueText = std::move(valueText), text = std::move(text), deferred](Napi::Env env, Napi::Function jsCallback) {
+                if (!promiseOnly_) {
+                    jsCallback.Call({EventKeys::Get(env, KEY_DATA), Napi::String::New(env, text)});
+                }
+                deferred.Resolve(Napi::String::New(env, valueText));
+            });
+            return;
+        }
+
+        tsfn_.NonBlockingCall([this, dataRef, resultData, deferred](Napi::Env env, Napi::Function jsCallback) {
+            if (env.IsExceptionPending()) {
+                printf("ReadData: Exception pending in env, clientID: %s\n", clientID_.c_str());
+                return;
+            }
+            Napi::Value result = resultData->ToNapi(env, 0);
+            if (!promiseOnly_) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                eventObj.Set(EventKeys::Get(env, KEY_DATA_REF), Napi::String::New(env, dataRef));
+                eventObj.Set(EventKeys::Get(env, KEY_VALUE), result);
+                eventObj.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, resultData->IsValid(0)));
+                std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                jsCallback.Call(args);
+            }
+            deferred.Resolve(result);
+        });
+
+    } catch (const std::exception& e) {
+        printf("Exception in ReadData: %s, clientID: %s\n", e.what(), clientID_.c_str());
+        std::string reason = std::string("Exception in ReadData: ") + e.what();
+        tsfn_.NonBlockingCall([this, reason, deferred](Napi::Env env, Napi::Function jsCallback) {
+            if (env.IsExceptionPending()) {
+                printf("ReadData: Exception pending in env, clientID: %s\n", clientID_.c_str());
+                return;
+            }
+            if (!promiseOnly_) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+                std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                jsCallback.Call(args);
+            }
+            deferred.Reject(Napi::Error::New(env, reason).Value());
+        });
+    }
+}
+
+// Pipelined mode keeps up to pipelineWindow_ requests outstanding on the association; sends that
+// do not fit wait in pipelineBacklog_. All of this state is only touched on the I/O thread.
+void MmsClient::SubmitPipelined(CommandQueue::Command send) {
+    if (inFlight_ < pipelineWindow_) {
+        inFlight_++;
+        send();
+    } else {
+        pipelineBacklog_.push_back(std::move(send));
+    }
+}
+
+// Frees the slot of a finished request
+void MmsClient::CompletePipelined() {
+    if (inFlight_ > 0) {
+        inFlight_--;
+    }
+    if (pipelineBacklog_.empty()) {
+        // Whatever made the server refuse calls has passed once the refused ones got through
+        pipelineWindow_ = windowLimit_;
+    }
+    PumpPipelined();
+}
+
+// Frees the slot of a request the server refused for too many outstanding calls and sends it again
+// first; until the backlog drains the window stays at the depth the server accepted
+void MmsClient::RetryPipelined(CommandQueue::Command send) {
+    pipelineWindow_ = std::max(1, inFlight_ - 1);
+    pipelineBacklog_.push_front(std::move(send));
+    CompletePipelined();
+}
+
+// The server may grant fewer outstanding calls than were asked for at association time;
+// more than that in flight would only come back as IED_ERROR_OUTSTANDING_CALL_LIMIT_REACHED.
+// One granted call is kept free for the blocking requests (readMany, controlObject, browse,
+// enableReporting) that the command queue sends while pipelined reads are outstanding.
+void MmsClient::ApplyNegotiatedWindow() {
+    MmsConnectionParameters parameters = MmsConnection_getMmsConnectionParameters(IedConnection_getMmsConnection(connection_));
+    windowLimit_ = requestedWindow_;
+    if (parameters.maxServOutstandingCalling > 0 && parameters.maxServOutstandingCalling <= windowLimit_) {
+        windowLimit_ = std::max(1, parameters.maxServOutstandingCalling - 1);
+        printf("Connect: Server granted %d outstanding calls of %d, window now %d, clientID: %s\n",
+               parameters.maxServOutstandingCalling, requestedWindow_, windowLimit_, clientID_.c_str());
+    }
+    pipelineWindow_ = windowLimit_;
+}
+
+// Sends queued requests while the window has room
+void MmsClient::PumpPipelined() {
+    while (inFlight_ < pipelineWindow_ && !pipelineBacklog_.empty()) {
+        CommandQueue::Command send = std::move(pipelineBacklog_.front());
+        pipelineBacklog_.pop_front();
+        inFlight_++;
+        send();
+    }
+}
+
+void MmsClient::SendPipelinedRead(PendingRead* read) {
+    if (read->options.Aborted()) {
+        // Dropped before it was sent: give the slot back, the caller is already pumping
+        inFlight_--;
+        RejectAborted(read->deferred);
+        delete read;
+        return;
+    }
+    // The timeout is taken when the request is sent, so the library abandons this invokeId on its own
+    RequestTimeoutScope timeoutScope(connection_, read->options.timeoutMs, requestTimeout_);
+    IedClientError error;
+    FunctionalConstraint fc = read->fcs[read->fcIndex];
+    IedConnection_readObjectAsync(connection_, &error, read->dataRef.c_str(), fc, ReadObjectHandler, read);
+    if (error != IED_ERROR_OK) {
+        // Not sent, the handler will not be called by the library
+        ReadObjectHandler(0, read, error, nullptr);
+    }
+}
+
+// Called on the library's receive thread; the response is handed back to the I/O thread
+void MmsClient::ReadObjectHandler(uint32_t invokeId, void* parameter, IedClientError err, MmsValue* value) {
+    PendingRead* read = static_cast<PendingRead*>(parameter);
+    MmsClient* client = read->client;
+    client->Post([client, read, err, value]() {
+        if (err == IED_ERROR_OUTSTANDING_CALL_LIMIT_REACHED) {
+            // Refused for a full window, not for the reference: send it again with the same FC once
+            // one of the other outstanding reads has finished
+            if (value != nullptr) {
+                MmsValue_delete(value);
             }
+            printf("ReadData: Outstanding call limit reached at %d calls, requeueing dataRef %s, clientID: %s\n",
+                   client->inFlight_.load(), read->dataRef.c_str(), client->clientID_.c_str());
+            client->RetryPipelined([client, read]() { client->SendPipelinedRead(read); });
+            return;
+        }
+        client->CompletePipelined();
+        FunctionalConstraint fc = read->fcs[read->fcIndex];
+        if (err == IED_ERROR_OK && value != nullptr) {
+            printf("ReadData: Succeeded with FC %d for dataRef %s, clientID: %s\n", fc, read->dataRef.c_str(), client->clientID_.c_str());
+            client->RememberFc(read->dataRef, fc);
+            client->CompleteRead(read->dataRef, value, err, read->deferred);
+            delete read;
+            return;
+        }
+        printf("ReadData: Failed with FC %d for dataRef %s, error: %d, clientID: %s\n", fc, read->dataRef.c_str(), err, client->clientID_.c_str());
+        if (value != nullptr) {
+            MmsValue_delete(value);
         }
+        if (read->fcIndex == 0) {
+            client->ForgetFc(read->dataRef);
+        }
+        // Fall back to the next functional constraint, unless the association itself failed
+        bool linkError = (err == IED_ERROR_NOT_CONNECTED || err == IED_ERROR_CONNECTION_LOST || err == IED_ERROR_TIMEOUT);
+        if (!linkError && client->connected_ && read->fcIndex + 1 < read->fcs.size()) {
+            read->fcIndex++;
+            client->SubmitPipelined([client, read]() { client->SendPipelinedRead(read); });
+            return;
+        }
+        client->CompleteRead(read->dataRef, nullptr, err, read->deferred);
+        delete read;
+    });
+}
 
-        std::function<ResultData(MmsValue*, const std::string&)> convertMmsValue;
-        convertMmsValue = [&](MmsValue* val, const std::string& attrName) -> ResultData {
-            ResultData data = { MmsValue_getType(val), 0.0f, 0, false, "", {}, {}, true, "" };
-            switch (data.type) {
-                case MMS_FLOAT:
-                    data.floatValue = MmsValue_toFloat(val);
-                    if (std::isnan(data.floatValue) || std::isinf(data.floatValue)) {
-                        data.isValid = false;
-                        data.errorReason = "Invalid float value";
-                    }
-                    break;
-                case MMS_INTEGER: {
-                    data.intValue = MmsValue_toInt32(val);
-                    if (attrName == "ctlModel") {
-                        switch (data.intValue) {
-                            case 0: data.stringValue = "status-only"; break;
-                            case 1: data.stringValue = "direct-with-normal-security"; break;
-                            case 2: data.stringValue = "sbo-with-normal-security"; break;
-                            case 3: data.stringValue = "direct-with-enhanced-security"; break;
-                            case 4: data.stringValue = "sbo-with-enhanced-security"; break;
-                            default: data.stringValue = "unknown(" + std::to_string(data.intValue) + ")";
-                        }
-                    }
-                    break;
+void MmsClient::ReadDataSetHandler(uint32_t invokeId, void* parameter, IedClientError err, ClientDataSet dataSet) {
+    PendingDataSetRead* read = static_cast<PendingDataSetRead*>(parameter);
+    MmsClient* client = read->client;
+    client->Post([client, read, err, dataSet]() {
+        client->CompletePipelined();
+        client->CompleteDataSetRead(read->datasetRef, dataSet, err, read->reply);
+        delete read;
+    });
+}
+
+// Maps "LD/LN.DO.DA" and a functional constraint to the MMS domain "LD" and item "LN$FC$DO$DA"
+static bool ToMmsVariable(const std::string& dataRef, FunctionalConstraint fc, std::string& domainId, std::string& itemId) {
+    size_t slash = dataRef.find('/');
+    if (slash == std::string::npos || slash == 0 || slash + 1 >= dataRef.size()) {
+        return false;
+    }
+    const char* fcString = FunctionalConstraint_toString(fc);
+    if (fcString == nullptr) {
+        return false;
+    }
+    domainId = dataRef.substr(0, slash);
+    std::string path = dataRef.substr(slash + 1);
+    size_t dot = path.find('.');
+    itemId = path.substr(0, dot) + "$" + fcString;
+    if (dot != std::string::npos) {
+        std::string rest = path.substr(dot);
+        for (char& c : rest) {
+            if (c == '.') c = '$';
+        }
+        itemId += rest;
+    }
+    return true;
+}
+
+Napi::Value MmsClient::ReadMany(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Expected refs (array)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Each entry is either a reference string (FC guessed like readData) or { ref, fc }
+    Napi::Array refs = info[0].As<Napi::Array>();
+    std::vector<ReadManyItem> items;
+    items.reserve(refs.Length());
+    for (uint32_t i = 0; i < refs.Length(); i++) {
+        Napi::Value entry = refs.Get(i);
+        ReadManyItem item;
+        if (entry.IsString()) {
+            item.dataRef = entry.As<Napi::String>().Utf8Value();
+        } else if (entry.IsObject() && entry.As<Napi::Object>().Get("ref").IsString()) {
+            Napi::Object obj = entry.As<Napi::Object>();
+            item.dataRef = obj.Get("ref").As<Napi::String>().Utf8Value();
+            if (obj.Get("fc").IsString()) {
+                FunctionalConstraint fc = FunctionalConstraint_fromString(obj.Get("fc").As<Napi::String>().Utf8Value().c_str());
+                if (fc == IEC61850_FC_NONE) {
+                    Napi::TypeError::New(env, "Invalid fc for " + item.dataRef).ThrowAsJavaScriptException();
+                    return env.Undefined();
                 }
-                case MMS_BOOLEAN:
-                    data.boolValue = MmsValue_getBoolean(val);
-                    printf("ReadData: Boolean value for %s: %d, clientID: %s\n", dataRef.c_str(), data.boolValue, clientID_.c_str());
-                    break;
-                case MMS_VISIBLE_STRING: {
-                    const char* str = MmsValue_toString(val);
-                    data.stringValue = str ? str : "";
-                    break;
+                item.fcs = {fc};
+            }
+        } else {
+            Napi::TypeError::New(env, "Expected refs entries to be strings or { ref, fc } objects").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        items.push_back(std::move(item));
+    }
+
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+
+    CallOptions options = ParseCallOptions(env, info[1]);
+    if (!connected_) {
+        printf("ReadMany: Not connected, clientID: %s\n", clientID_.c_str());
+        deferred.Reject(Napi::Error::New(env, "Not connected").Value());
+        return deferred.Promise();
+    }
+
+    Post(CommandQueue::LANE_POLLING, [this, options, items = std::move(items), deferred]() mutable {
+        if (!connected_) {
+            printf("ReadMany: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+                deferred.Reject(Napi::Error::New(env, "Not connected").Value());
+            });
+            return;
+        }
+        if (options.Aborted()) {
+            RejectAborted(deferred);
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+
+        std::vector<MmsValue*> values(items.size(), nullptr);
+        std::vector<IedClientError> errors(items.size(), IED_ERROR_OK);
+        try {
+            MmsConnection mms = IedConnection_getMmsConnection(connection_);
+            int maxPduSize = MmsConnection_getMmsConnectionParameters(mms).maxPduSize;
+            if (maxPduSize <= 0) {
+                maxPduSize = 65000;
+            }
+
+            // References without an explicit FC start with the cached or guessed one
+            std::vector<bool> explicitFc(items.size());
+            for (size_t i = 0; i < items.size(); i++) {
+                explicitFc[i] = !items[i].fcs.empty();
+                if (!explicitFc[i]) {
+                    items[i].fcs = ResolveFcOrder(items[i].dataRef);
                 }
-                case MMS_UTC_TIME: {
-                    uint64_t timestamp = MmsValue_getUtcTimeInMs(val);
-                    time_t time = timestamp / 1000;
-                    char timeStr[64];
-                    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", gmtime(&time));
-                    data.stringValue = std::string(timeStr) + "." + std::to_string(timestamp % 1000);
-                    break;
+            }
+
+            // Group by logical device (the MMS domain), FC order inside a domain
+            std::vector<std::string> itemIds(items.size());
+            std::map<std::string, std::vector<size_t>> byDomain;
+            for (size_t i = 0; i < items.size(); i++) {
+                std::string domainId;
+                if (ToMmsVariable(items[i].dataRef, items[i].fcs[0], domainId, itemIds[i])) {
+                    byDomain[domainId].push_back(i);
                 }
-                case MMS_BIT_STRING: {
-                    int bitSize = MmsValue_getBitStringSize(val);
-                    if (attrName == "q") {
-                        uint32_t quality = MmsValue_getBitStringAsInteger(val);
-                        std::string qualityStr;
-                        if (quality & QUALITY_VALIDITY_INVALID) qualityStr += "Invalid|";
-                        if (quality & QUALITY_VALIDITY_QUESTIONABLE) qualityStr += "Questionable|";
-                        if (qualityStr.empty()) qualityStr = "Good";
-                        else qualityStr.pop_back();
-                        data.stringValue = qualityStr;
-                    } else {
-                        char bitStr[128];
-                        snprintf(bitStr, sizeof(bitStr), "BitString(size=%d)", bitSize);
-                        data.stringValue = bitStr;
+            }
+
+            size_t requests = 0;
+            for (auto& [domainId, indices] : byDomain) {
+                std::stable_sort(indices.begin(), indices.end(), [&items](size_t a, size_t b) {
+                    return items[a].fcs[0] < items[b].fcs[0];
+                });
+
+                // Pack items while both the request and a minimal response still fit into one PDU
+                std::vector<size_t> chunk;
+                int requestSize = READ_MANY_PDU_OVERHEAD;
+                int responseSize = READ_MANY_PDU_OVERHEAD;
+                for (size_t index : indices) {
+                    int itemSize = int(domainId.size() + itemIds[index].size()) + READ_MANY_ITEM_OVERHEAD;
+                    if (!chunk.empty() && (requestSize + itemSize > maxPduSize || responseSize + READ_MANY_VALUE_SIZE > maxPduSize)) {
+                        ReadManyChunk(mms, domainId, itemIds, chunk, values);
+                        requests++;
+                        chunk.clear();
+                        requestSize = READ_MANY_PDU_OVERHEAD;
+                        responseSize = READ_MANY_PDU_OVERHEAD;
                     }
-                    break;
+                    chunk.push_back(index);
+                    requestSize += itemSize;
+                    responseSize += READ_MANY_VALUE_SIZE;
                 }
-                case MMS_STRUCTURE: {
-                    int size = MmsValue_getArraySize(val);
-                    for (int i = 0; i < size; i++) {
-                        MmsValue* element = MmsValue_getElement(val, i);
-                        if (element) {
-                            std::string subAttrName = attrName + ".field" + std::to_string(i);
-                            ResultData subData = convertMmsValue(element, subAttrName);
-                            if (subData.isValid) {
-                                data.structureElements.push_back(subData);
-                            }
-                        }
-                    }
-                    break;
+                if (!chunk.empty()) {
+                    ReadManyChunk(mms, domainId, itemIds, chunk, values);
+                    requests++;
                 }
-                case MMS_ARRAY: {
-                    int size = MmsValue_getArraySize(val);
-                    for (int i = 0; i < size; i++) {
-                        MmsValue* element = MmsValue_getElement(val, i);
-                        if (element) {
-                            ResultData subData = convertMmsValue(element, attrName);
-                            data.arrayElements.push_back(subData);
-                        }
+            }
+            printf("ReadMany: %zu references in %zu requests, clientID: %s\n", items.size(), requests, clientID_.c_str());
+
+            // Whatever the packed reads could not deliver goes through the readData FC fallback
+            for (size_t i = 0; i < items.size(); i++) {
+                if (explicitFc[i]) continue;
+                if (values[i] != nullptr) {
+                    RememberFc(items[i].dataRef, items[i].fcs[0]);
+                    continue;
+                }
+                ForgetFc(items[i].dataRef);
+            }
+            for (size_t i = 0; i < items.size(); i++) {
+                if (values[i] != nullptr || !connected_) continue;
+                for (auto tryFc : items[i].fcs) {
+                    values[i] = IedConnection_readObject(connection_, &errors[i], items[i].dataRef.c_str(), tryFc);
+                    if (errors[i] == IED_ERROR_OK && values[i] != nullptr) {
+                        if (!explicitFc[i]) RememberFc(items[i].dataRef, tryFc);
+                        break;
+                    }
+                    if (values[i] != nullptr) {
+                        MmsValue_delete(values[i]);
+                        values[i] = nullptr;
                     }
-                    break;
                 }
-                case MMS_DATA_ACCESS_ERROR:
-                    data.isValid = false;
-                    data.errorReason = "Data access error";
-                    printf("ReadData: Data access error for dataRef %s, clientID: %s\n", dataRef.c_str(), clientID_.c_str());
-                    break;
-                default:
-                    data.isValid = false;
-                    data.errorReason = "Unsupported type: " + std::to_string(data.type);
-                    printf("ReadData: Unsupported type %d for dataRef %s, clientID: %s\n", data.type, dataRef.c_str(), clientID_.c_str());
             }
-            return data;
-        };
+        } catch (const std::exception& e) {
+            printf("Exception in ReadMany: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            for (MmsValue* value : values) {
+                if (value != nullptr) MmsValue_delete(value);
+            }
+            std::string reason = std::string("Exception in ReadMany: ") + e.what();
+            tsfn_.NonBlockingCall([this, reason, deferred](Napi::Env env, Napi::Function jsCallback) {
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+                    jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                }
+                deferred.Reject(Napi::Error::New(env, reason).Value());
+            });
+            return;
+        }
 
-        ResultData resultData = convertMmsValue(value, dataRef.substr(dataRef.rfind(".") + 1));
-        MmsValue_delete(value);
+        auto results = std::make_shared<FlatMmsValue>(convert_);
+        for (size_t i = 0; i < items.size(); i++) {
+            const std::string& dataRef = items[i].dataRef;
+            if (values[i] != nullptr) {
+                std::shared_ptr<const FieldNames> names;
+                if (namedFields_ && MmsValue_getType(values[i]) == MMS_STRUCTURE) {
+                    names = FieldNamesFor(dataRef);
+                }
+                results->Append(values[i], FlatMmsValue::HintForAttribute(dataRef.substr(dataRef.rfind(".") + 1)), names);
+                MmsValue_delete(values[i]);
+            } else {
+                results->AppendInvalid("Read failed, error: " + std::to_string(errors[i]));
+            }
+        }
 
-        tsfn_.NonBlockingCall([this, dataRef, resultData](Napi::Env env, Napi::Function jsCallback) {
-            if (env.IsExceptionPending()) {
-                printf("ReadData: Exception pending in env, clientID: %s\n", clientID_.c_str());
-                return;
+        tsfn_.NonBlockingCall([this, items, results, deferred](Napi::Env env, Napi::Function jsCallback) {
+            Napi::Array resultArray = Napi::Array::New(env, results->RootCount());
+            for (size_t i = 0; i < results->RootCount(); i++) {
+                Napi::Object entry = Napi::Object::New(env);
+                entry.Set(EventKeys::Get(env, KEY_DATA_REF), Napi::String::New(env, items[i].dataRef));
+                entry.Set(EventKeys::Get(env, KEY_VALUE), results->ToNapi(env, i));
+                entry.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, results->IsValid(i)));
+                resultArray.Set(uint32_t(i), entry);
             }
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "data"));
-            eventObj.Set("dataRef", Napi::String::New(env, dataRef));
 
-            std::function<Napi::Value(const ResultData&)> toNapiValue = [&](const ResultData& data) -> Napi::Value {
-                if (!data.isValid) {
-                    return Napi::String::New(env, data.errorReason);
-                }
-                switch (data.type) {
-                    case MMS_FLOAT:
-                        return Napi::Number::New(env, data.floatValue);
-                    case MMS_INTEGER:
-                        if (!data.stringValue.empty()) {
-                            return Napi::String::New(env, data.stringValue);
-                        }
-                        return Napi::Number::New(env, data.intValue);
-                    case MMS_BOOLEAN:
-                        return Napi::Boolean::New(env, data.boolValue);
-                    case MMS_VISIBLE_STRING:
-                    case MMS_UTC_TIME:
-                    case MMS_BIT_STRING:
-                        return Napi::String::New(env, data.stringValue);
-                    case MMS_STRUCTURE: {
-                        Napi::Object structObj = Napi::Object::New(env);
-                        for (size_t i = 0; i < data.structureElements.size(); i++) {
-                            structObj.Set(Napi::String::New(env, "field" + std::to_string(i)), toNapiValue(data.structureElements[i]));
-                        }
-                        return structObj;
-                    }
-                    case MMS_ARRAY: {
-                        Napi::Array array = Napi::Array::New(env, data.arrayElements.size());
-                        for (size_t i = 0; i < data.arrayElements.size(); i++) {
-                            array.Set(uint32_t(i), toNapiValue(data.arrayElements[i]));
-                        }
-                        return array;
-                    }
-                    default:
-                        return Napi::String::New(env, "Unsupported type");
-                }
-            };
+            if (!promiseOnly_) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_READ_MANY));
+                eventObj.Set(EventKeys::Get(env, KEY_RESULTS), resultArray);
+                jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            }
 
-            Napi::Value result = toNapiValue(resultData);
-            eventObj.Set("value", result);
-            eventObj.Set("isValid", Napi::Boolean::New(env, resultData.isValid));
-            std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-            jsCallback.Call(args);
+            deferred.Resolve(resultArray);
         });
+    });
 
-        return env.Undefined();
-    } catch (const std::exception& e) {
-        printf("Exception in ReadData: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
-            if (env.IsExceptionPending()) {
-                printf("ReadData: Exception pending in env, clientID: %s\n", clientID_.c_str());
-                return;
+    return deferred.Promise();
+}
+
+// One multi-variable Read of a single domain. A request the server refuses as a whole (typically
+// because the response would exceed the PDU size) is retried as two halves; items that still
+// fail are left as nullptr for the single-read fallback.
+void MmsClient::ReadManyChunk(MmsConnection mms, const std::string& domainId, const std::vector<std::string>& itemIds,
+                              const std::vector<size_t>& chunk, std::vector<MmsValue*>& values) {
+    LinkedList variables = LinkedList_create();
+    for (size_t index : chunk) {
+        LinkedList_add(variables, (void*)itemIds[index].c_str());
+    }
+    MmsError mmsError;
+    MmsValue* result = MmsConnection_readMultipleVariables(mms, &mmsError, domainId.c_str(), variables);
+    LinkedList_destroyStatic(variables);
+
+    if (result != nullptr && MmsValue_getType(result) == MMS_ARRAY && MmsValue_getArraySize(result) == chunk.size()) {
+        for (size_t i = 0; i < chunk.size(); i++) {
+            MmsValue* element = MmsValue_getElement(result, int(i));
+            if (element != nullptr && MmsValue_getType(element) != MMS_DATA_ACCESS_ERROR) {
+                values[chunk[i]] = MmsValue_clone(element);
+            }
+        }
+        MmsValue_delete(result);
+        return;
+    }
+    if (result != nullptr) {
+        MmsValue_delete(result);
+    }
+
+    printf("ReadMany: Multi-variable read of %zu items in %s failed, error: %d, clientID: %s\n",
+           chunk.size(), domainId.c_str(), mmsError, clientID_.c_str());
+    if (chunk.size() < 2 || mmsError == MMS_ERROR_CONNECTION_LOST || mmsError == MMS_ERROR_SERVICE_TIMEOUT) {
+        return;
+    }
+    size_t half = chunk.size() / 2;
+    ReadManyChunk(mms, domainId, itemIds, std::vector<size_t>(chunk.begin(), chunk.begin() + half), values);
+    ReadManyChunk(mms, domainId, itemIds, std::vector<size_t>(chunk.begin() + half, chunk.end()), values);
+}
+
+// Reads stVal after a control and reports it
+void MmsClient::SendControlStatus(ReplyPtr reply, const std::string& stValRef, bool success) {
+    IedClientError stError;
+    MmsValue* stVal = IedConnection_readObject(connection_, &stError, stValRef.c_str(), IEC61850_FC_ST);
+    if (stError == IED_ERROR_OK && stVal != nullptr) {
+        bool state = MmsValue_getBoolean(stVal);
+        printf("New status of %s: %d\n", stValRef.c_str(), state);
+        tsfn_.NonBlockingCall([this, reply, stValRef, state, success](Napi::Env env, Napi::Function jsCallback) {
+            Napi::Object eventObj = Napi::Object::New(env);
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), Napi::String::New(env, success ? "data" : "error"));
+            eventObj.Set(EventKeys::Get(env, KEY_DATA_REF), Napi::String::New(env, stValRef));
+            eventObj.Set(EventKeys::Get(env, KEY_VALUE), Napi::Boolean::New(env, state));
+            eventObj.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, true));
+            if (!success) {
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Control operation failed, current status reported"));
             }
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+        });
+        MmsValue_delete(stVal);
+    } else {
+        printf("Failed to read status for %s, error: %d\n", stValRef.c_str(), stError);
+        tsfn_.NonBlockingCall([this, reply, stValRef](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in ReadData: ") + e.what()));
-            std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-            jsCallback.Call(args);
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+            eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to read status for " + stValRef + " after control"));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         });
-        return env.Undefined();
     }
 }
 
@@ -1107,627 +2383,610 @@ Napi::Value MmsClient::ControlObject(const Napi::CallbackInfo& info) {
     std::string dataRef = info[0].As<Napi::String>().Utf8Value();
     bool controlValue = info[1].As<Napi::Boolean>().Value();
 
-    std::lock_guard<std::mutex> lock(connMutex_);
+    ReplyPtr reply = NewReply(env);
+    CallOptions options = ParseCallOptions(env, info[2]);
     if (!connected_) {
         printf("ControlObject: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+        return Fail(env, reply, "Not connected");
     }
 
-    try {
-        IedClientError error;
-
-        // Read ctlModel
-        std::string ctlModelRef = dataRef + ".ctlModel";
-        printf("Reading ctlModel from: %s (FC=CF)\n", ctlModelRef.c_str());
-
-        MmsValue* ctlModelValue = IedConnection_readObject(
-            connection_, &error,
-            ctlModelRef.c_str(),
-            IEC61850_FC_CF
-        );
-
-        int32_t ctlModel = 0;
-        if (error == IED_ERROR_OK && ctlModelValue != nullptr) {
-            ctlModel = MmsValue_toInt32(ctlModelValue);
-            printf("ctlModel read successfully: %d\n", ctlModel);
-            MmsValue_delete(ctlModelValue);
-        } else {
-            printf("Failed to read ctlModel (error: %d). Falling back to ctlModel=1\n", error);
-            ctlModel = 1; // Fallback to direct-with-normal-security
-        }
-
-        // Check if control is allowed
-        if (ctlModel == 0) {
-            printf("Control blocked: ctlModel=status-only\n");
-            tsfn_.NonBlockingCall([this, dataRef](Napi::Env env, Napi::Function jsCallback) {
+    Post(CommandQueue::LANE_CONTROL, [this, options, reply, dataRef, controlValue]() {
+        if (!connected_) {
+            printf("ControlObject: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Control blocked for " + dataRef + ": status-only"));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
         }
+        if (options.Aborted()) {
+            EmitAborted(reply, "ControlObject");
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+        try {
+            IedClientError error;
 
-        // Prepare control operation
-        std::string operRef = dataRef + ".Oper";
-        std::string stValRef = dataRef + ".stVal";
-        printf("Attempting control on: %s\n", operRef.c_str());
-
-        // Helper function to read and send status update
-        auto sendStatusUpdate = [&](bool success) {
-            IedClientError stError;
-            MmsValue* stVal = IedConnection_readObject(connection_, &stError, stValRef.c_str(), IEC61850_FC_ST);
-            if (stError == IED_ERROR_OK && stVal != nullptr) {
-                bool state = MmsValue_getBoolean(stVal);
-                printf("New status of %s: %d\n", stValRef.c_str(), state);
-                tsfn_.NonBlockingCall([this, stValRef, state, success](Napi::Env env, Napi::Function jsCallback) {
-                    Napi::Object eventObj = Napi::Object::New(env);
-                    eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                    eventObj.Set("type", Napi::String::New(env, success ? "data" : "error"));
-                    eventObj.Set("dataRef", Napi::String::New(env, stValRef));
-                    eventObj.Set("value", Napi::Boolean::New(env, state));
-                    eventObj.Set("isValid", Napi::Boolean::New(env, true));
-                    if (!success) {
-                        eventObj.Set("reason", Napi::String::New(env, "Control operation failed, current status reported"));
-                    }
-                    jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-                });
-                MmsValue_delete(stVal);
+            // Read ctlModel
+            std::string ctlModelRef = dataRef + ".ctlModel";
+            printf("Reading ctlModel from: %s (FC=CF)\n", ctlModelRef.c_str());
+
+            MmsValue* ctlModelValue = IedConnection_readObject(
+                connection_, &error,
+                ctlModelRef.c_str(),
+                IEC61850_FC_CF
+            );
+
+            int32_t ctlModel = 0;
+            if (error == IED_ERROR_OK && ctlModelValue != nullptr) {
+                ctlModel = MmsValue_toInt32(ctlModelValue);
+                printf("ctlModel read successfully: %d\n", ctlModel);
+                MmsValue_delete(ctlModelValue);
             } else {
-                printf("Failed to read status for %s, error: %d\n", stValRef.c_str(), stError);
-                tsfn_.NonBlockingCall([this, stValRef](Napi::Env env, Napi::Function jsCallback) {
+                printf("Failed to read ctlModel (error: %d). Falling back to ctlModel=1\n", error);
+                ctlModel = 1; // Fallback to direct-with-normal-security
+            }
+
+            // Check if control is allowed
+            if (ctlModel == 0) {
+                printf("Control blocked: ctlModel=status-only\n");
+                tsfn_.NonBlockingCall([this, reply, dataRef](Napi::Env env, Napi::Function jsCallback) {
                     Napi::Object eventObj = Napi::Object::New(env);
-                    eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                    eventObj.Set("type", Napi::String::New(env, "error"));
-                    eventObj.Set("reason", Napi::String::New(env, "Failed to read status for " + stValRef + " after control"));
-                    jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Control blocked for " + dataRef + ": status-only"));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
                 });
+                return;
             }
-        };
 
-        // Command termination handler for enhanced security
-        auto commandTerminationHandler = [](void* parameter, ControlObjectClient control) {
-            MmsClient* client = static_cast<MmsClient*>(parameter);
-            LastApplError lastApplError = ControlObjectClient_getLastApplError(control);
-            std::string status = (lastApplError.error != 0) ? "CommandTermination-" : "CommandTermination+";
-            printf("%s\n", status.c_str());
-            if (lastApplError.error != 0) {
-                printf(" LastApplError: %i\n", lastApplError.error);
-                printf("      addCause: %i\n", lastApplError.addCause);
-            }
-            client->tsfn_.NonBlockingCall([client, status, lastApplError](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, client->clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "control"));
-                eventObj.Set("event", Napi::String::New(env, status));
+            // Prepare control operation
+            std::string operRef = dataRef + ".Oper";
+            std::string stValRef = dataRef + ".stVal";
+            printf("Attempting control on: %s\n", operRef.c_str());
+
+            // Command termination handler for enhanced security
+            auto commandTerminationHandler = [](void* parameter, ControlObjectClient control) {
+                MmsClient* client = static_cast<MmsClient*>(parameter);
+                LastApplError lastApplError = ControlObjectClient_getLastApplError(control);
+                std::string status = (lastApplError.error != 0) ? "CommandTermination-" : "CommandTermination+";
+                printf("%s\n", status.c_str());
                 if (lastApplError.error != 0) {
-                    eventObj.Set("error", Napi::Number::New(env, lastApplError.error));
-                    eventObj.Set("addCause", Napi::Number::New(env, lastApplError.addCause));
+                    printf(" LastApplError: %i\n", lastApplError.error);
+                    printf("      addCause: %i\n", lastApplError.addCause);
                 }
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-            });
-        };
+                client->tsfn_.NonBlockingCall([client, status, lastApplError](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), client->ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+                    eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, status));
+                    if (lastApplError.error != 0) {
+                        eventObj.Set("error", Napi::Number::New(env, lastApplError.error));
+                        eventObj.Set("addCause", Napi::Number::New(env, lastApplError.addCause));
+                    }
+                    jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                });
+            };
 
-        // Create control object
-        ControlObjectClient control = ControlObjectClient_create(dataRef.c_str(), connection_);
-        if (!control) {
-            printf("Control object %s not found in server\n", operRef.c_str());
-            tsfn_.NonBlockingCall([this, dataRef](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to create control object for " + dataRef));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-            });
-            return env.Undefined();
-        }
+            // Create control object
+            ControlObjectClient control = ControlObjectClient_create(dataRef.c_str(), connection_);
+            if (!control) {
+                printf("Control object %s not found in server\n", operRef.c_str());
+                tsfn_.NonBlockingCall([this, reply, dataRef](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to create control object for " + dataRef));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                });
+                return;
+            }
 
-        MmsValue* ctlVal = MmsValue_newBoolean(controlValue);
-        if (!ctlVal) {
-            printf("Failed to create MmsValue for control\n");
-            ControlObjectClient_destroy(control);
-            tsfn_.NonBlockingCall([this, dataRef](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to create control value for " + dataRef));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-            });
-            return env.Undefined();
-        }
+            MmsValue* ctlVal = MmsValue_newBoolean(controlValue);
+            if (!ctlVal) {
+                printf("Failed to create MmsValue for control\n");
+                ControlObjectClient_destroy(control);
+                tsfn_.NonBlockingCall([this, reply, dataRef](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to create control value for " + dataRef));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                });
+                return;
+            }
 
-        bool operateSuccess = false;
+            bool operateSuccess = false;
+            bool awaitTermination = false;
 
-        // Direct control (ctlModel = 1)
-        if (ctlModel == 1) {
-            printf("Using DIRECT control (ctlModel=%d)\n", ctlModel);
-            ControlObjectClient_setOrigin(control, NULL, 3);
-            operateSuccess = ControlObjectClient_operate(control, ctlVal, 1);
-        }
-        // SBO control (ctlModel = 2)
-        else if (ctlModel == 2) {
-            printf("Using SBO control (ctlModel=%d)\n", ctlModel);
-            if (ControlObjectClient_select(control)) {
+            // Direct control (ctlModel = 1)
+            if (ctlModel == 1) {
+                printf("Using DIRECT control (ctlModel=%d)\n", ctlModel);
+                ControlObjectClient_setOrigin(control, NULL, 3);
+                operateSuccess = ControlObjectClient_operate(control, ctlVal, 1);
+            }
+            // SBO control (ctlModel = 2)
+            else if (ctlModel == 2) {
+                printf("Using SBO control (ctlModel=%d)\n", ctlModel);
+                if (ControlObjectClient_select(control)) {
+                    operateSuccess = ControlObjectClient_operate(control, ctlVal, 0);
+                } else {
+                    printf("SBO select failed for %s\n", operRef.c_str());
+                    MmsValue_delete(ctlVal);
+                    ControlObjectClient_destroy(control);
+                    tsfn_.NonBlockingCall([this, reply, dataRef](Napi::Env env, Napi::Function jsCallback) {
+                        Napi::Object eventObj = Napi::Object::New(env);
+                        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "SBO select failed for " + dataRef));
+                        if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                    });
+                    return;
+                }
+            }
+            // Direct control with enhanced security (ctlModel = 3)
+            else if (ctlModel == 3) {
+                printf("Using DIRECT control with enhanced security (ctlModel=%d)\n", ctlModel);
+                ControlObjectClient_setCommandTerminationHandler(control, commandTerminationHandler, this);
+                ControlObjectClient_setOrigin(control, nullptr, 3);
                 operateSuccess = ControlObjectClient_operate(control, ctlVal, 0);
-            } else {
-                printf("SBO select failed for %s\n", operRef.c_str());
-                MmsValue_delete(ctlVal);
-                ControlObjectClient_destroy(control);
-                tsfn_.NonBlockingCall([this, dataRef](Napi::Env env, Napi::Function jsCallback) {
+                awaitTermination = true;
+            }
+            // SBO with enhanced security (ctlModel = 4)
+            else if (ctlModel == 4) {
+                printf("Using SBO control with enhanced security (ctlModel=%d)\n", ctlModel);
+                ControlObjectClient_setCommandTerminationHandler(control, commandTerminationHandler, this);
+                if (ControlObjectClient_selectWithValue(control, ctlVal)) {
+                    operateSuccess = ControlObjectClient_operate(control, ctlVal, 0);
+                    awaitTermination = true;
+                } else {
+                    printf("SBO selectWithValue failed for %s\n", operRef.c_str());
+                    MmsValue_delete(ctlVal);
+                    ControlObjectClient_destroy(control);
+                    tsfn_.NonBlockingCall([this, reply, dataRef](Napi::Env env, Napi::Function jsCallback) {
+                        Napi::Object eventObj = Napi::Object::New(env);
+                        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "SBO selectWithValue failed for " + dataRef));
+                        if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                    });
+                    return;
+                }
+            }
+
+            // Send control operation result
+            if (operateSuccess) {
+                printf("Control operation succeeded for %s\n", operRef.c_str());
+                tsfn_.NonBlockingCall([this, reply, dataRef, controlValue](Napi::Env env, Napi::Function jsCallback) {
                     Napi::Object eventObj = Napi::Object::New(env);
-                    eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                    eventObj.Set("type", Napi::String::New(env, "error"));
-                    eventObj.Set("reason", Napi::String::New(env, "SBO select failed for " + dataRef));
-                    jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+                    eventObj.Set(EventKeys::Get(env, KEY_DATA_REF), Napi::String::New(env, dataRef));
+                    eventObj.Set(EventKeys::Get(env, KEY_VALUE), Napi::Boolean::New(env, controlValue));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
                 });
-                return env.Undefined();
-            }
-        }
-        // Direct control with enhanced security (ctlModel = 3)
-        else if (ctlModel == 3) {
-            printf("Using DIRECT control with enhanced security (ctlModel=%d)\n", ctlModel);
-            ControlObjectClient_setCommandTerminationHandler(control, commandTerminationHandler, this);
-            ControlObjectClient_setOrigin(control, nullptr, 3);
-            operateSuccess = ControlObjectClient_operate(control, ctlVal, 0);
-            // Wait for command termination
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        }
-        // SBO with enhanced security (ctlModel = 4)
-        else if (ctlModel == 4) {
-            printf("Using SBO control with enhanced security (ctlModel=%d)\n", ctlModel);
-            ControlObjectClient_setCommandTerminationHandler(control, commandTerminationHandler, this);
-            if (ControlObjectClient_selectWithValue(control, ctlVal)) {
-                operateSuccess = ControlObjectClient_operate(control, ctlVal, 0);
-                // Wait for command termination
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
             } else {
-                printf("SBO selectWithValue failed for %s\n", operRef.c_str());
-                MmsValue_delete(ctlVal);
-                ControlObjectClient_destroy(control);
-                tsfn_.NonBlockingCall([this, dataRef](Napi::Env env, Napi::Function jsCallback) {
+                printf("Control operation failed for %s\n", operRef.c_str());
+                tsfn_.NonBlockingCall([this, reply, dataRef](Napi::Env env, Napi::Function jsCallback) {
                     Napi::Object eventObj = Napi::Object::New(env);
-                    eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                    eventObj.Set("type", Napi::String::New(env, "error"));
-                    eventObj.Set("reason", Napi::String::New(env, "SBO selectWithValue failed for " + dataRef));
-                    jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Control failed for " + dataRef));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
                 });
-                return env.Undefined();
             }
-        }
 
-        // Send control operation result
-        if (operateSuccess) {
-            printf("Control operation succeeded for %s\n", operRef.c_str());
-            tsfn_.NonBlockingCall([this, dataRef, controlValue](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "control"));
-                eventObj.Set("dataRef", Napi::String::New(env, dataRef));
-                eventObj.Set("value", Napi::Boolean::New(env, controlValue));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-            });
-        } else {
-            printf("Control operation failed for %s\n", operRef.c_str());
-            tsfn_.NonBlockingCall([this, dataRef](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Control failed for " + dataRef));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-            });
-        }
+            if (awaitTermination) {
+                // The control object has to live until the command termination arrives. Waiting for
+                // it here would hold this connection's actor (in threadless mode a shared worker), so
+                // the status read and the cleanup run as a deferred command instead.
+                Defer(CONTROL_TERMINATION_WAIT, [this, reply, stValRef, operateSuccess, control, ctlVal]() {
+                    SendControlStatus(reply, stValRef, operateSuccess);
+                    MmsValue_delete(ctlVal);
+                    ControlObjectClient_destroy(control);
+                });
+                return;
+            }
 
-        // Cleanup
-        MmsValue_delete(ctlVal);
-        ControlObjectClient_destroy(control);
+            // Cleanup
+            MmsValue_delete(ctlVal);
+            ControlObjectClient_destroy(control);
 
-        // Send status update
-        sendStatusUpdate(operateSuccess);
+            // Send status update
+            SendControlStatus(reply, stValRef, operateSuccess);
 
-        return env.Undefined();
-    } catch (const std::exception& e) {
-        printf("Exception in ControlObject: %s\n", e.what());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
-        return env.Undefined();
-    }
+            return;
+        } catch (const std::exception& e) {
+            printf("Exception in ControlObject: %s\n", e.what());
+            tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Exception: ") + e.what()));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+    });
+    return ReplyValue(env, reply);
 }
 
 Napi::Value MmsClient::GetLogicalDevices(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
 
-    std::lock_guard<std::mutex> lock(connMutex_);
+    CallOptions options = ParseCallOptions(env, info[0]);
     if (!connected_) {
         printf("GetLogicalDevices: Not connected, clientID: %s\n", clientID_.c_str());
         deferred.Reject(Napi::Error::New(env, "Not connected").Value());
         return deferred.Promise();
     }
 
-    try {
-        IedClientError error;
+    Post(CommandQueue::LANE_BROWSE, [this, options, deferred]() {
+        if (!connected_) {
+            printf("GetLogicalDevices: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([deferred](Napi::Env env, Napi::Function jsCallback) {
+                deferred.Reject(Napi::Error::New(env, "Not connected").Value());
+            });
+            return;
+        }
+        if (options.Aborted()) {
+            RejectAborted(deferred);
+            return;
+        }
+        RequestTimeoutScope timeoutScope(connection_, options.timeoutMs, requestTimeout_);
+
+        try {
+            IedClientError error;
+
+            struct DataAttribute {
+                std::string name;
+                MmsType type;
+                std::string value;
+                bool isValid;
+            };
 
-        struct DataAttribute {
-            std::string name;
-            MmsType type;
-            std::string value;
-            bool isValid;
-        };
-
-        struct DataObject {
-            std::string name;
-            std::vector<DataAttribute> attributes;
-            std::vector<DataObject> subObjects;
-        };
-
-        struct LogicalNode {
-            std::string name;
-            std::vector<DataObject> dataObjects;
-        };
-
-        struct LogicalDevice {
-            std::string name;
-            std::vector<LogicalNode> logicalNodes;
-        };
-
-        std::vector<LogicalDevice> logicalDevices;
-
-        auto mmsValueToString = [](MmsValue* value) -> std::string {
-            if (!value) return "null";
-            switch (MmsValue_getType(value)) {
-                case MMS_FLOAT:
-                    return std::to_string(MmsValue_toFloat(value));
-                case MMS_INTEGER: {
-                    int32_t intVal = MmsValue_toInt32(value);
-                    if (MmsValue_getType(value) == MMS_INTEGER && intVal >= 0 && intVal <= 4) {
-                        switch (intVal) {
-                            case 0: return "status-only";
-                            case 1: return "direct-with-normal-security";
-                            case 2: return "sbo-with-normal-security";
-                            case 3: return "direct-with-enhanced-security";
-                            case 4: return "sbo-with-enhanced-security";
-                            default: return "unknown(" + std::to_string(intVal) + ")";
+            struct DataObject {
+                std::string name;
+                std::vector<DataAttribute> attributes;
+                std::vector<DataObject> subObjects;
+            };
+
+            struct LogicalNode {
+                std::string name;
+                std::vector<DataObject> dataObjects;
+            };
+
+            struct LogicalDevice {
+                std::string name;
+                std::vector<LogicalNode> logicalNodes;
+            };
+
+            std::vector<LogicalDevice> logicalDevices;
+
+            auto mmsValueToString = [](MmsValue* value) -> std::string {
+                if (!value) return "null";
+                switch (MmsValue_getType(value)) {
+                    case MMS_FLOAT:
+                        return std::to_string(MmsValue_toFloat(value));
+                    case MMS_INTEGER: {
+                        int32_t intVal = MmsValue_toInt32(value);
+                        if (MmsValue_getType(value) == MMS_INTEGER && intVal >= 0 && intVal <= 4) {
+                            switch (intVal) {
+                                case 0: return "status-only";
+                                case 1: return "direct-with-normal-security";
+                                case 2: return "sbo-with-normal-security";
+                                case 3: return "direct-with-enhanced-security";
+                                case 4: return "sbo-with-enhanced-security";
+                                default: return "unknown(" + std::to_string(intVal) + ")";
+                            }
                         }
+                        return std::to_string(intVal);
                     }
-                    return std::to_string(intVal);
-                }
-                case MMS_BOOLEAN:
-                    return MmsValue_getBoolean(value) ? "true" : "false";
-                case MMS_VISIBLE_STRING: {
-                    const char* str = MmsValue_toString(value);
-                    return str ? str : "";
-                }
-                case MMS_UTC_TIME: {
-                    uint64_t timestamp = MmsValue_getUtcTimeInMs(value);
-                    time_t time = timestamp / 1000;
-                    char timeStr[64];
-                    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", gmtime(&time));
-                    return std::string(timeStr) + "." + std::to_string(timestamp % 1000);
-                }
-                case MMS_BIT_STRING: {
-                    int bitSize = MmsValue_getBitStringSize(value);
-                    return "BitString(size=" + std::to_string(bitSize) + ")";
+                    case MMS_BOOLEAN:
+                        return MmsValue_getBoolean(value) ? "true" : "false";
+                    case MMS_VISIBLE_STRING: {
+                        const char* str = MmsValue_toString(value);
+                        return str ? str : "";
+                    }
+                    case MMS_UTC_TIME: {
+                        char timeStr[64];
+                        size_t length = FormatUtcTime(MmsValue_getUtcTimeInMs(value), timeStr, sizeof(timeStr));
+                        return std::string(timeStr, length);
+                    }
+                    case MMS_BIT_STRING: {
+                        int bitSize = MmsValue_getBitStringSize(value);
+                        return "BitString(size=" + std::to_string(bitSize) + ")";
+                    }
+                    case MMS_STRUCTURE:
+                    case MMS_ARRAY:
+                        return "complex";
+                    case MMS_DATA_ACCESS_ERROR:
+                        return "access_error";
+                    default:
+                        return "unsupported_type_" + std::to_string(MmsValue_getType(value));
                 }
-                case MMS_STRUCTURE:
-                case MMS_ARRAY:
-                    return "complex";
-                case MMS_DATA_ACCESS_ERROR:
-                    return "access_error";
-                default:
-                    return "unsupported_type_" + std::to_string(MmsValue_getType(value));
-            }
-        };
-
-        auto readAttributeValue = [&](const std::string& ref, FunctionalConstraint fc) -> DataAttribute {
-            DataAttribute attr;
-            attr.name = ref.substr(ref.rfind(".") + 1);
-            attr.isValid = false;
-            attr.value = "unreadable";
-
-            IedClientError readError;
-            MmsValue* value = nullptr;
-            std::vector<FunctionalConstraint> fcs = {
-                fc, IEC61850_FC_ALL, IEC61850_FC_ST, IEC61850_FC_MX,
-                IEC61850_FC_DC, IEC61850_FC_SP, IEC61850_FC_CO, IEC61850_FC_CF
             };
-            for (auto tryFc : fcs) {
-                value = IedConnection_readObject(connection_, &readError, ref.c_str(), tryFc);
-                if (readError == IED_ERROR_OK && value != nullptr) {
-                    printf("readAttributeValue: Succeeded with FC %d for %s, clientID: %s\n", tryFc, ref.c_str(), clientID_.c_str());
-                    break;
+
+            auto readAttributeValue = [&](const std::string& ref, FunctionalConstraint fc) -> DataAttribute {
+                DataAttribute attr;
+                attr.name = ref.substr(ref.rfind(".") + 1);
+                attr.isValid = false;
+                attr.value = "unreadable";
+
+                IedClientError readError;
+                MmsValue* value = nullptr;
+                std::vector<FunctionalConstraint> fcs = {
+                    fc, IEC61850_FC_ALL, IEC61850_FC_ST, IEC61850_FC_MX,
+                    IEC61850_FC_DC, IEC61850_FC_SP, IEC61850_FC_CO, IEC61850_FC_CF
+                };
+                for (auto tryFc : fcs) {
+                    value = IedConnection_readObject(connection_, &readError, ref.c_str(), tryFc);
+                    if (readError == IED_ERROR_OK && value != nullptr) {
+                        printf("readAttributeValue: Succeeded with FC %d for %s, clientID: %s\n", tryFc, ref.c_str(), clientID_.c_str());
+                        RememberFc(ref, tryFc);
+                        break;
+                    }
+                    printf("readAttributeValue: Failed with FC %d for %s, error: %d, clientID: %s\n", tryFc, ref.c_str(), readError, clientID_.c_str());
                 }
-                printf("readAttributeValue: Failed with FC %d for %s, error: %d, clientID: %s\n", tryFc, ref.c_str(), readError, clientID_.c_str());
-            }
 
-            if (readError == IED_ERROR_OK && value != nullptr) {
-                attr.type = MmsValue_getType(value);
-                attr.value = mmsValueToString(value);
-                attr.isValid = (attr.type != MMS_DATA_ACCESS_ERROR);
-                printf("readAttributeValue: Value for %s: %s, type: %d, isValid: %d, clientID: %s\n",
-                       ref.c_str(), attr.value.c_str(), attr.type, attr.isValid, clientID_.c_str());
-                MmsValue_delete(value);
-            } else {
-                std::string errorMsg;
-                switch (readError) {
-                    case IED_ERROR_OBJECT_DOES_NOT_EXIST: errorMsg = "Object does not exist"; break;
-                    case IED_ERROR_ACCESS_DENIED: errorMsg = "Access denied"; break;
-                    case IED_ERROR_TYPE_INCONSISTENT: errorMsg = "Type inconsistent"; break;
-                    case IED_ERROR_OBJECT_ACCESS_UNSUPPORTED: errorMsg = "Object access unsupported"; break;
-                    default: errorMsg = "Unknown error: " + std::to_string(readError);
+                if (readError == IED_ERROR_OK && value != nullptr) {
+                    attr.type = MmsValue_getType(value);
+                    attr.value = mmsValueToString(value);
+                    attr.isValid = (attr.type != MMS_DATA_ACCESS_ERROR);
+                    printf("readAttributeValue: Value for %s: %s, type: %d, isValid: %d, clientID: %s\n",
+                           ref.c_str(), attr.value.c_str(), attr.type, attr.isValid, clientID_.c_str());
+                    MmsValue_delete(value);
+                } else {
+                    std::string errorMsg;
+                    switch (readError) {
+                        case IED_ERROR_OBJECT_DOES_NOT_EXIST: errorMsg = "Object does not exist"; break;
+                        case IED_ERROR_ACCESS_DENIED: errorMsg = "Access denied"; break;
+                        case IED_ERROR_TYPE_INCONSISTENT: errorMsg = "Type inconsistent"; break;
+                        case IED_ERROR_OBJECT_ACCESS_UNSUPPORTED: errorMsg = "Object access unsupported"; break;
+                        default: errorMsg = "Unknown error: " + std::to_string(readError);
+                    }
+                    attr.value = errorMsg;
+                    printf("readAttributeValue: Failed to read %s with all FCs, final error: %s, clientID: %s\n", ref.c_str(), errorMsg.c_str(), clientID_.c_str());
                 }
-                attr.value = errorMsg;
-                printf("readAttributeValue: Failed to read %s with all FCs, final error: %s, clientID: %s\n", ref.c_str(), errorMsg.c_str(), clientID_.c_str());
-            }
-            return attr;
-        };
-
-        std::function<void(const std::string&, DataObject&, FunctionalConstraint)> processDataObject;
-        processDataObject = [&](const std::string& parentRef, DataObject& dataObj, FunctionalConstraint fc) {
-            IedClientError doError;
-            LinkedList attrList = IedConnection_getDataDirectory(connection_, &doError, parentRef.c_str());
-            if (doError == IED_ERROR_OK && attrList != nullptr) {
-                printf("Successfully retrieved data directory for %s, clientID: %s\n", parentRef.c_str(), clientID_.c_str());
-                LinkedList currentAttr = attrList;
-                while (currentAttr != nullptr) {
-                    if (currentAttr->data != nullptr) {
-                        char* attrName = (char*)currentAttr->data;
-                        std::string attrRef = parentRef + "." + attrName;
-
-                        FunctionalConstraint attrFc = fc;
-                        if (std::string(attrName) == "Oper") {
-                            attrFc = IEC61850_FC_CO;
-                        } else if (std::string(attrName) == "ctlModel") {
-                            attrFc = IEC61850_FC_CF;
-                        } else if (std::string(attrName).find("NamPlt") != std::string::npos || std::string(attrName).find("PhyNam") != std::string::npos) {
-                            attrFc = IEC61850_FC_DC;
-                        } else if (std::string(attrName).find("Mod") != std::string::npos || std::string(attrName).find("Proxy") != std::string::npos) {
-                            attrFc = IEC61850_FC_ST;
-                        } else if (std::string(attrName).find("SPCSO") != std::string::npos) {
-                            attrFc = IEC61850_FC_ST;
-                        } else if (std::string(attrName).find("AnIn") != std::string::npos) {
-                            attrFc = IEC61850_FC_MX;
-                        }
+                return attr;
+            };
+
+            std::function<void(const std::string&, DataObject&, FunctionalConstraint)> processDataObject;
+            processDataObject = [&](const std::string& parentRef, DataObject& dataObj, FunctionalConstraint fc) {
+                IedClientError doError;
+                LinkedList attrList = IedConnection_getDataDirectory(connection_, &doError, parentRef.c_str());
+                if (doError == IED_ERROR_OK && attrList != nullptr) {
+                    printf("Successfully retrieved data directory for %s, clientID: %s\n", parentRef.c_str(), clientID_.c_str());
+                    LinkedList currentAttr = attrList;
+                    while (currentAttr != nullptr) {
+                        if (currentAttr->data != nullptr) {
+                            char* attrName = (char*)currentAttr->data;
+                            std::string attrRef = parentRef + "." + attrName;
+
+                            FunctionalConstraint attrFc = fc;
+                            if (std::string(attrName) == "Oper") {
+                                attrFc = IEC61850_FC_CO;
+                            } else if (std::string(attrName) == "ctlModel") {
+                                attrFc = IEC61850_FC_CF;
+                            } else if (std::string(attrName).find("NamPlt") != std::string::npos || std::string(attrName).find("PhyNam") != std::string::npos) {
+                                attrFc = IEC61850_FC_DC;
+                            } else if (std::string(attrName).find("Mod") != std::string::npos || std::string(attrName).find("Proxy") != std::string::npos) {
+                                attrFc = IEC61850_FC_ST;
+                            } else if (std::string(attrName).find("SPCSO") != std::string::npos) {
+                                attrFc = IEC61850_FC_ST;
+                            } else if (std::string(attrName).find("AnIn") != std::string::npos) {
+                                attrFc = IEC61850_FC_MX;
+                            }
 
-                        DataAttribute attr = readAttributeValue(attrRef, attrFc);
-                        dataObj.attributes.push_back(attr);
-
-                        IedClientError subError;
-                        LinkedList subAttrList = IedConnection_getDataDirectory(connection_, &subError, attrRef.c_str());
-                        if (subError == IED_ERROR_OK && subAttrList != nullptr) {
-                            DataObject subObj;
-                            subObj.name = attrName;
-                            processDataObject(attrRef, subObj, attrFc);
-                            dataObj.subObjects.push_back(subObj); // Всегда добавляем подобъект
-                            LinkedList_destroy(subAttrList);
+                            DataAttribute attr = readAttributeValue(attrRef, attrFc);
+                            dataObj.attributes.push_back(attr);
+
+                            IedClientError subError;
+                            LinkedList subAttrList = IedConnection_getDataDirectory(connection_, &subError, attrRef.c_str());
+                            if (subError == IED_ERROR_OK && subAttrList != nullptr) {
+                                DataObject subObj;
+                                subObj.name = attrName;
+                                processDataObject(attrRef, subObj, attrFc);
+                                dataObj.subObjects.push_back(subObj); // Всегда добавляем подобъект
+                                LinkedList_destroy(subAttrList);
+                            }
                         }
+                        currentAttr = LinkedList_getNext(currentAttr);
                     }
-                    currentAttr = LinkedList_getNext(currentAttr);
+                    LinkedList_destroy(attrList);
+                } else {
+                    printf("Failed to get data directory for %s, error: %d, clientID: %s\n", parentRef.c_str(), doError, clientID_.c_str());
                 }
-                LinkedList_destroy(attrList);
-            } else {
-                printf("Failed to get data directory for %s, error: %d, clientID: %s\n", parentRef.c_str(), doError, clientID_.c_str());
+            };
+
+            // Получение списка логических устройств
+            LinkedList deviceList = IedConnection_getLogicalDeviceList(connection_, &error);
+            if (error != IED_ERROR_OK || deviceList == nullptr) {
+                printf("Failed to get logical device list, error: %d, clientID: %s\n", error, clientID_.c_str());
+                tsfn_.NonBlockingCall([this, deferred](Napi::Env env, Napi::Function jsCallback) {
+                    if (!promiseOnly_) {
+                        Napi::Object eventObj = Napi::Object::New(env);
+                        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to get logical device list"));
+                        std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                        jsCallback.Call(args);
+                    }
+                    deferred.Reject(Napi::Error::New(env, "Failed to get logical device list").Value());
+                });
+                return;
             }
-        };
 
-        // Получение списка логических устройств
-        LinkedList deviceList = IedConnection_getLogicalDeviceList(connection_, &error);
-        if (error != IED_ERROR_OK || deviceList == nullptr) {
-            printf("Failed to get logical device list, error: %d, clientID: %s\n", error, clientID_.c_str());
-            tsfn_.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to get logical device list"));
-                std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-                jsCallback.Call(args);
-            });
-            deferred.Reject(Napi::Error::New(env, "Failed to get logical device list").Value());
-            return deferred.Promise();
-        }
-
-        LinkedList currentDevice = deviceList;
-        while (currentDevice != nullptr) {
-            if (currentDevice->data != nullptr) {
-                char* deviceName = (char*)currentDevice->data;
-                LogicalDevice ld;
-                ld.name = std::string(deviceName);
-                printf("Processing logical device %s, clientID: %s\n", ld.name.c_str(), clientID_.c_str());
-
-                // Получение списка логических узлов
-                LinkedList nodeList = IedConnection_getLogicalDeviceDirectory(connection_, &error, ld.name.c_str());
-                if (error != IED_ERROR_OK || nodeList == nullptr) {
-                    printf("Failed to get logical node list for %s, error: %d, clientID: %s\n", ld.name.c_str(), error, clientID_.c_str());
-                    currentDevice = LinkedList_getNext(currentDevice);
-                    continue;
-                }
+            LinkedList currentDevice = deviceList;
+            while (currentDevice != nullptr) {
+                if (currentDevice->data != nullptr) {
+                    char* deviceName = (char*)currentDevice->data;
+                    LogicalDevice ld;
+                    ld.name = std::string(deviceName);
+                    printf("Processing logical device %s, clientID: %s\n", ld.name.c_str(), clientID_.c_str());
+
+                    // Получение списка логических узлов
+                    LinkedList nodeList = IedConnection_getLogicalDeviceDirectory(connection_, &error, ld.name.c_str());
+                    if (error != IED_ERROR_OK || nodeList == nullptr) {
+                        printf("Failed to get logical node list for %s, error: %d, clientID: %s\n", ld.name.c_str(), error, clientID_.c_str());
+                        currentDevice = LinkedList_getNext(currentDevice);
+                        continue;
+                    }
 
-                LinkedList currentNode = nodeList;
-                while (currentNode != nullptr) {
-                    if (currentNode->data != nullptr) {
-                        char* nodeName = (char*)currentNode->data;
-                        LogicalNode ln;
-                        ln.name = std::string(nodeName);
-                        std::string nodeRef = ld.name + "/" + ln.name;
-                        printf("Processing logical node %s, clientID: %s\n", nodeRef.c_str(), clientID_.c_str());
-
-                        // Получение списка объектов данных
-                        LinkedList doList = IedConnection_getLogicalNodeVariables(connection_, &error, nodeRef.c_str());
-                        if (error != IED_ERROR_OK || doList == nullptr) {
-                            printf("Failed to get data object list for %s, error: %d, clientID: %s\n", nodeRef.c_str(), error, clientID_.c_str());
-                            currentNode = LinkedList_getNext(currentNode);
-                            continue;
-                        }
+                    LinkedList currentNode = nodeList;
+                    while (currentNode != nullptr) {
+                        if (currentNode->data != nullptr) {
+                            char* nodeName = (char*)currentNode->data;
+                            LogicalNode ln;
+                            ln.name = std::string(nodeName);
+                            std::string nodeRef = ld.name + "/" + ln.name;
+                            printf("Processing logical node %s, clientID: %s\n", nodeRef.c_str(), clientID_.c_str());
+
+                            // Получение списка объектов данных
+                            LinkedList doList = IedConnection_getLogicalNodeVariables(connection_, &error, nodeRef.c_str());
+                            if (error != IED_ERROR_OK || doList == nullptr) {
+                                printf("Failed to get data object list for %s, error: %d, clientID: %s\n", nodeRef.c_str(), error, clientID_.c_str());
+                                currentNode = LinkedList_getNext(currentNode);
+                                continue;
+                            }
 
-                        LinkedList currentDo = doList;
-                        while (currentDo != nullptr) {
-                            if (currentDo->data != nullptr) {
-                                char* doName = (char*)currentDo->data;
-                                std::string doRef = nodeRef + "." + doName;
-                                DataObject dataObj;
-                                dataObj.name = doName;
-
-                                // Определение подходящего FC на основе имени объекта
-                                FunctionalConstraint doFc = IEC61850_FC_ALL;
-                                if (std::string(doName).find("Oper") != std::string::npos) {
-                                    doFc = IEC61850_FC_CO;
-                                } else if (std::string(doName).find("ctlModel") != std::string::npos) {
-                                    doFc = IEC61850_FC_CF;
-                                } else if (std::string(doName).find("NamPlt") != std::string::npos || std::string(doName).find("PhyNam") != std::string::npos) {
-                                    doFc = IEC61850_FC_DC;
-                                } else if (std::string(doName).find("Mod") != std::string::npos || std::string(doName).find("Proxy") != std::string::npos) {
-                                    doFc = IEC61850_FC_ST;
-                                } else if (std::string(doName).find("SPCSO") != std::string::npos) {
-                                    doFc = IEC61850_FC_ST;
-                                } else if (std::string(doName).find("AnIn") != std::string::npos) {
-                                    doFc = IEC61850_FC_MX;
-                                } else if (std::string(doName).find("EventsBRCB") != std::string::npos || std::string(doName).find("Measurements") != std::string::npos) {
-                                    doFc = IEC61850_FC_BR;
-                                } else if (std::string(doName).find("EventsRCB") != std::string::npos || std::string(doName).find("EventsIndexed") != std::string::npos) {
-                                    doFc = IEC61850_FC_RP;
-                                }
+                            LinkedList currentDo = doList;
+                            while (currentDo != nullptr) {
+                                if (currentDo->data != nullptr) {
+                                    char* doName = (char*)currentDo->data;
+                                    std::string doRef = nodeRef + "." + doName;
+                                    DataObject dataObj;
+                                    dataObj.name = doName;
+
+                                    // Определение подходящего FC на основе имени объекта
+                                    FunctionalConstraint doFc = IEC61850_FC_ALL;
+                                    if (std::string(doName).find("Oper") != std::string::npos) {
+                                        doFc = IEC61850_FC_CO;
+                                    } else if (std::string(doName).find("ctlModel") != std::string::npos) {
+                                        doFc = IEC61850_FC_CF;
+                                    } else if (std::string(doName).find("NamPlt") != std::string::npos || std::string(doName).find("PhyNam") != std::string::npos) {
+                                        doFc = IEC61850_FC_DC;
+                                    } else if (std::string(doName).find("Mod") != std::string::npos || std::string(doName).find("Proxy") != std::string::npos) {
+                                        doFc = IEC61850_FC_ST;
+                                    } else if (std::string(doName).find("SPCSO") != std::string::npos) {
+                                        doFc = IEC61850_FC_ST;
+                                    } else if (std::string(doName).find("AnIn") != std::string::npos) {
+                                        doFc = IEC61850_FC_MX;
+                                    } else if (std::string(doName).find("EventsBRCB") != std::string::npos || std::string(doName).find("Measurements") != std::string::npos) {
+                                        doFc = IEC61850_FC_BR;
+                                    } else if (std::string(doName).find("EventsRCB") != std::string::npos || std::string(doName).find("EventsIndexed") != std::string::npos) {
+                                        doFc = IEC61850_FC_RP;
+                                    }
 
-                                processDataObject(doRef, dataObj, doFc);
-                                ln.dataObjects.push_back(dataObj); // Всегда добавляем объект данных
+                                    processDataObject(doRef, dataObj, doFc);
+                                    ln.dataObjects.push_back(dataObj); // Всегда добавляем объект данных
+                                }
+                                currentDo = LinkedList_getNext(currentDo);
                             }
-                            currentDo = LinkedList_getNext(currentDo);
-                        }
-                        LinkedList_destroy(doList);
+                            LinkedList_destroy(doList);
 
-                        ld.logicalNodes.push_back(ln); // Всегда добавляем логический узел
+                            ld.logicalNodes.push_back(ln); // Всегда добавляем логический узел
+                        }
+                        currentNode = LinkedList_getNext(currentNode);
                     }
-                    currentNode = LinkedList_getNext(currentNode);
-                }
-                LinkedList_destroy(nodeList);
+                    LinkedList_destroy(nodeList);
 
-                logicalDevices.push_back(ld); // Всегда добавляем логическое устройство
+                    logicalDevices.push_back(ld); // Всегда добавляем логическое устройство
+                }
+                currentDevice = LinkedList_getNext(currentDevice);
             }
-            currentDevice = LinkedList_getNext(currentDevice);
-        }
-        LinkedList_destroy(deviceList);
-
-        if (logicalDevices.empty()) {
-            printf("No valid logical devices found, clientID: %s\n", clientID_.c_str());
-            tsfn_.NonBlockingCall([this](Napi::Env env, Napi::Function jsCallback) {
-                Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "No valid logical devices found"));
-                std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-                jsCallback.Call(args);
-            });
-            deferred.Reject(Napi::Error::New(env, "No valid logical devices found").Value());
-            return deferred.Promise();
-        }
+            LinkedList_destroy(deviceList);
 
-        tsfn_.NonBlockingCall([this, logicalDevices](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "data"));
-            eventObj.Set("event", Napi::String::New(env, "logicalDevices"));
-
-            auto toNapiObject = [](Napi::Env env, const auto& obj, auto toNapiFunc) -> Napi::Value {
-                Napi::Object napiObj = Napi::Object::New(env);
-                napiObj.Set("name", Napi::String::New(env, obj.name));
-                if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, DataAttribute>) {
-                    napiObj.Set("type", Napi::Number::New(env, obj.type));
-                    napiObj.Set("value", Napi::String::New(env, obj.value));
-                    napiObj.Set("isValid", Napi::Boolean::New(env, obj.isValid));
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, DataObject>) {
-                    Napi::Array attrs = Napi::Array::New(env, obj.attributes.size());
-                    for (size_t i = 0; i < obj.attributes.size(); i++) {
-                        attrs.Set(uint32_t(i), toNapiFunc(env, obj.attributes[i], toNapiFunc));
-                    }
-                    napiObj.Set("attributes", attrs);
-                    Napi::Array subObjs = Napi::Array::New(env, obj.subObjects.size());
-                    for (size_t i = 0; i < obj.subObjects.size(); i++) {
-                        subObjs.Set(uint32_t(i), toNapiFunc(env, obj.subObjects[i], toNapiFunc));
-                    }
-                    napiObj.Set("subObjects", subObjs);
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, LogicalNode>) {
-                    Napi::Array dataObjs = Napi::Array::New(env, obj.dataObjects.size());
-                    for (size_t i = 0; i < obj.dataObjects.size(); i++) {
-                        dataObjs.Set(uint32_t(i), toNapiFunc(env, obj.dataObjects[i], toNapiFunc));
+            if (logicalDevices.empty()) {
+                printf("No valid logical devices found, clientID: %s\n", clientID_.c_str());
+                tsfn_.NonBlockingCall([this, deferred](Napi::Env env, Napi::Function jsCallback) {
+                    if (!promiseOnly_) {
+                        Napi::Object eventObj = Napi::Object::New(env);
+                        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "No valid logical devices found"));
+                        std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                        jsCallback.Call(args);
                     }
-                    napiObj.Set("dataObjects", dataObjs);
-                } else {
-                    Napi::Array nodes = Napi::Array::New(env, obj.logicalNodes.size());
-                    for (size_t i = 0; i < obj.logicalNodes.size(); i++) {
-                        nodes.Set(uint32_t(i), toNapiFunc(env, obj.logicalNodes[i], toNapiFunc));
+                    deferred.Reject(Napi::Error::New(env, "No valid logical devices found").Value());
+                });
+                return;
+            }
+
+            tsfn_.NonBlockingCall([this, logicalDevices, deferred](Napi::Env env, Napi::Function jsCallback) {
+                auto toNapiObject = [](Napi::Env env, const auto& obj, auto toNapiFunc) -> Napi::Value {
+                    Napi::Object napiObj = Napi::Object::New(env);
+                    napiObj.Set(EventKeys::Get(env, KEY_NAME), Napi::String::New(env, obj.name));
+                    if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, DataAttribute>) {
+                        napiObj.Set(EventKeys::Get(env, KEY_TYPE), Napi::Number::New(env, obj.type));
+                        napiObj.Set(EventKeys::Get(env, KEY_VALUE), Napi::String::New(env, obj.value));
+                        napiObj.Set(EventKeys::Get(env, KEY_IS_VALID), Napi::Boolean::New(env, obj.isValid));
+                    } else if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, DataObject>) {
+                        Napi::Array attrs = Napi::Array::New(env, obj.attributes.size());
+                        for (size_t i = 0; i < obj.attributes.size(); i++) {
+                            attrs.Set(uint32_t(i), toNapiFunc(env, obj.attributes[i], toNapiFunc));
+                        }
+                        napiObj.Set("attributes", attrs);
+                        Napi::Array subObjs = Napi::Array::New(env, obj.subObjects.size());
+                        for (size_t i = 0; i < obj.subObjects.size(); i++) {
+                            subObjs.Set(uint32_t(i), toNapiFunc(env, obj.subObjects[i], toNapiFunc));
+                        }
+                        napiObj.Set("subObjects", subObjs);
+                    } else if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, LogicalNode>) {
+                        Napi::Array dataObjs = Napi::Array::New(env, obj.dataObjects.size());
+                        for (size_t i = 0; i < obj.dataObjects.size(); i++) {
+                            dataObjs.Set(uint32_t(i), toNapiFunc(env, obj.dataObjects[i], toNapiFunc));
+                        }
+                        napiObj.Set("dataObjects", dataObjs);
+                    } else {
+                        Napi::Array nodes = Napi::Array::New(env, obj.logicalNodes.size());
+                        for (size_t i = 0; i < obj.logicalNodes.size(); i++) {
+                            nodes.Set(uint32_t(i), toNapiFunc(env, obj.logicalNodes[i], toNapiFunc));
+                        }
+                        napiObj.Set("logicalNodes", nodes);
                     }
-                    napiObj.Set("logicalNodes", nodes);
-                }
-                return napiObj;
-            };
+                    return napiObj;
+                };
 
-            Napi::Array devicesArray = Napi::Array::New(env, logicalDevices.size());
-            for (size_t i = 0; i < logicalDevices.size(); i++) {
-                devicesArray.Set(uint32_t(i), toNapiObject(env, logicalDevices[i], toNapiObject));
-            }
-            eventObj.Set("logicalDevices", devicesArray);
+                Napi::Array devicesArray = Napi::Array::New(env, logicalDevices.size());
+                for (size_t i = 0; i < logicalDevices.size(); i++) {
+                    devicesArray.Set(uint32_t(i), toNapiObject(env, logicalDevices[i], toNapiObject));
+                }
 
-            std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-            jsCallback.Call(args);
-        });
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+                    eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "logicalDevices"));
+                    eventObj.Set("logicalDevices", devicesArray);
+                    std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                    jsCallback.Call(args);
+                }
 
-        Napi::Array resultArray = Napi::Array::New(env, logicalDevices.size());
-        for (size_t i = 0; i < logicalDevices.size(); i++) {
-            auto toNapiObject = [](Napi::Env env, const auto& obj, auto toNapiFunc) -> Napi::Value {
-                Napi::Object napiObj = Napi::Object::New(env);
-                napiObj.Set("name", Napi::String::New(env, obj.name));
-                if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, DataAttribute>) {
-                    napiObj.Set("type", Napi::Number::New(env, obj.type));
-                    napiObj.Set("value", Napi::String::New(env, obj.value));
-                    napiObj.Set("isValid", Napi::Boolean::New(env, obj.isValid));
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, DataObject>) {
-                    Napi::Array attrs = Napi::Array::New(env, obj.attributes.size());
-                    for (size_t i = 0; i < obj.attributes.size(); i++) {
-                        attrs.Set(uint32_t(i), toNapiFunc(env, obj.attributes[i], toNapiFunc));
-                    }
-                    napiObj.Set("attributes", attrs);
-                    Napi::Array subObjs = Napi::Array::New(env, obj.subObjects.size());
-                    for (size_t i = 0; i < obj.subObjects.size(); i++) {
-                        subObjs.Set(uint32_t(i), toNapiFunc(env, obj.subObjects[i], toNapiFunc));
-                    }
-                    napiObj.Set("subObjects", subObjs);
-                } else if constexpr (std::is_same_v<std::decay_t<decltype(obj)>, LogicalNode>) {
-                    Napi::Array dataObjs = Napi::Array::New(env, obj.dataObjects.size());
-                    for (size_t i = 0; i < obj.dataObjects.size(); i++) {
-                        dataObjs.Set(uint32_t(i), toNapiFunc(env, obj.dataObjects[i], toNapiFunc));
-                    }
-                    napiObj.Set("dataObjects", dataObjs);
-                } else {
-                    Napi::Array nodes = Napi::Array::New(env, obj.logicalNodes.size());
-                    for (size_t i = 0; i < obj.logicalNodes.size(); i++) {
-                        nodes.Set(uint32_t(i), toNapiFunc(env, obj.logicalNodes[i], toNapiFunc));
-                    }
-                    napiObj.Set("logicalNodes", nodes);
+                deferred.Resolve(devicesArray);
+            });
+        } catch (const std::exception& e) {
+            printf("Exception in GetLogicalDevices: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            std::string reason = std::string("Exception in GetLogicalDevices: ") + e.what();
+            tsfn_.NonBlockingCall([this, reason, deferred](Napi::Env env, Napi::Function jsCallback) {
+                if (!promiseOnly_) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+                    std::vector<napi_value> args = {EventKeys::Get(env, KEY_DATA), eventObj};
+                    jsCallback.Call(args);
                 }
-                return napiObj;
-            };
-            resultArray.Set(uint32_t(i), toNapiObject(env, logicalDevices[i], toNapiObject));
+                deferred.Reject(Napi::Error::New(env, reason).Value());
+            });
         }
-        deferred.Resolve(resultArray);
-        return deferred.Promise();
-    } catch (const std::exception& e) {
-        printf("Exception in GetLogicalDevices: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in GetLogicalDevices: ") + e.what()));
-            std::vector<napi_value> args = {Napi::String::New(env, "data"), eventObj};
-            jsCallback.Call(args);
-        });
-        deferred.Reject(Napi::Error::New(env, std::string("Exception in GetLogicalDevices: ") + e.what()).Value());
-        return deferred.Promise();
-    }
+    });
+
+    return deferred.Promise();
 }
 
 Napi::Value MmsClient::Close(const Napi::CallbackInfo& info) {
@@ -1735,210 +2994,460 @@ Napi::Value MmsClient::Close(const Napi::CallbackInfo& info) {
     Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
 
     try {
-        {
-            std::lock_guard<std::mutex> lock(connMutex_);
-            if (running_) {
-                running_ = false;
-                if (connected_) {
-                    printf("Close called by client, clientID: %s\n", clientID_.c_str());
-                    IedConnection_close(connection_);
-                    connected_ = false;
-                }
-            }
+        if (running_) {
+            printf("Close called by client, clientID: %s\n", clientID_.c_str());
+        }
+        StopIoThread();
+
+        if (connection_) {
+            printf("Destroying connection, clientID: %s\n", clientID_.c_str());
+            IedConnection_destroy(connection_);
+            connection_ = nullptr;
+        }
+        if (tsfn_) {
+            printf("Releasing TSFN, clientID: %s\n", clientID_.c_str());
+            tsfn_.Release();
+            tsfn_ = Napi::ThreadSafeFunction();
         }
 
-        if (thread_.joinable()) {
-            thread_.join();
+        deferred.Resolve(Napi::Boolean::New(env, true));
+    } catch (const std::exception& e) {
+        printf("Exception in Close: %s, clientID: %s\n", e.what(), clientID_.c_str());
+        deferred.Reject(Napi::Error::New(env, std::string("Close failed: ") + e.what()).Value());
+    }
+
+    return deferred.Promise();
+}
+
+Napi::Value MmsClient::GetStatus(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object status = Napi::Object::New(env);
+    status.Set("connected", Napi::Boolean::New(env, connected_.load()));
+    status.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+
+    Napi::Object queues = Napi::Object::New(env);
+    for (int lane = 0; lane < CommandQueue::LANE_COUNT; lane++) {
+        CommandQueue::LaneStats stats = commands_.Stats(static_cast<CommandQueue::Lane>(lane));
+        Napi::Object laneObj = Napi::Object::New(env);
+        laneObj.Set("depth", Napi::Number::New(env, static_cast<double>(stats.depth)));
+        laneObj.Set("executed", Napi::Number::New(env, static_cast<double>(stats.executed)));
+        laneObj.Set("avgWaitMs", Napi::Number::New(env, stats.avgWaitMs));
+        laneObj.Set("maxWaitMs", Napi::Number::New(env, stats.maxWaitMs));
+        queues.Set(CommandQueue::LaneName(static_cast<CommandQueue::Lane>(lane)), laneObj);
+    }
+    status.Set("queues", queues);
+    if (events_) {
+        status.Set("events", EventQueueStatsToNapi(env, eventQueue_, events_->Stats()));
+    }
+    return status;
+}
+
+// Without reportBatch every report is its own event; with it, reports wait in batch_ until
+// maxReports are collected or the oldest one waited maxLatencyMs. Any thread.
+void MmsClient::DeliverReport(const std::string& rcbRef, ReportEvent event, std::shared_ptr<ReportAck> ack) {
+    if (batchMaxReports_ == 0) {
+        EmitData(rcbRef, [event = std::move(event), ack = std::move(ack)](Napi::Env env, Napi::Function jsCallback) {
+            jsCallback.Call({EventKeys::Get(env, KEY_DATA), event(env)});
+            if (ack) ack->Acknowledge();
+        });
+        return;
+    }
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    OpenBatch();
+    batch_.push_back(std::move(event));
+    if (ack) batchAcks_.push_back(std::move(ack));
+    if (batch_.size() >= batchMaxReports_) {
+        EmitBatch();
+    }
+}
+
+void MmsClient::DeliverReportJson(const std::string& rcbRef, std::string text, std::shared_ptr<ReportAck> ack) {
+    if (batchMaxReports_ == 0) {
+        EmitData(rcbRef, [text = std::move(text), ack = std::move(ack)](Napi::Env env, Napi::Function jsCallback) {
+            jsCallback.Call({EventKeys::Get(env, KEY_DATA), Napi::String::New(env, text)});
+            if (ack) ack->Acknowledge();
+        });
+        return;
+    }
+    // A batch of JSON reports is NDJSON, one report per line
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    OpenBatch();
+    if (ack) batchAcks_.push_back(std::move(ack));
+    batchJson_ += text;
+    batchJson_ += '\n';
+    if (++batchJsonCount_ >= batchMaxReports_) {
+        EmitBatch();
+    }
+}
+
+// batchMutex_ held
+void MmsClient::OpenBatch() {
+    if (batchPending_) {
+        return;
+    }
+    batchDeadline_ = std::chrono::steady_clock::now() + batchMaxLatency_;
+    batchPending_ = true;
+    if (!threadless_) {
+        // Lets the I/O thread shorten its wait to the deadline
+        commands_.Notify();
+    }
+}
+
+// batchMutex_ held
+void MmsClient::EmitBatch() {
+    if (!batchPending_) {
+        return;
+    }
+    batchPending_ = false;
+    // The journal moves on once the whole batch has reached JS
+    auto acks = std::make_shared<std::vector<std::shared_ptr<ReportAck>>>();
+    acks->swap(batchAcks_);
+    // Batches are never coalesced, they hold reports of several RCBs
+    if (format_ == ValueFormat::Json) {
+        EmitData(std::string(), [text = std::move(batchJson_), acks](Napi::Env env, Napi::Function jsCallback) {
+            jsCallback.Call({EventKeys::Get(env, KEY_DATA), Napi::String::New(env, text)});
+            for (auto& ack : *acks) ack->Acknowledge();
+        });
+        batchJson_.clear();
+        batchJsonCount_ = 0;
+        return;
+    }
+    std::vector<ReportEvent> batch;
+    batch.swap(batch_);
+    EmitData(std::string(), [this, batch = std::move(batch), acks](Napi::Env env, Napi::Function jsCallback) {
+        Napi::Object eventObj = Napi::Object::New(env);
+        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_REPORTS));
+        Napi::Array reports = Napi::Array::New(env, batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            reports.Set(uint32_t(i), batch[i](env));
         }
+        eventObj.Set(EventKeys::Get(env, KEY_REPORTS), reports);
+        jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+        for (auto& ack : *acks) ack->Acknowledge();
+    });
+}
 
-        {
-            std::lock_guard<std::mutex> lock(connMutex_);
-            if (connection_) {
-                printf("Destroying connection, clientID: %s\n", clientID_.c_str());
-                IedConnection_destroy(connection_);
-                connection_ = nullptr;
-            }
-            if (tsfn_) {
-                printf("Releasing TSFN, clientID: %s\n", clientID_.c_str());
-                tsfn_.Release();
-                tsfn_ = Napi::ThreadSafeFunction();
-            }
-        }
+void MmsClient::FlushReports() {
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    EmitBatch();
+}
 
-        deferred.Resolve(Napi::Boolean::New(env, true));
-    } catch (const std::exception& e) {
-        printf("Exception in Close: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        deferred.Reject(Napi::Error::New(env, std::string("Close failed: ") + e.what()).Value());
+// Called by the loops that drive the connection: the I/O thread, the ticker threads and the
+// node loop tick
+void MmsClient::FlushReportsIfDue(std::chrono::steady_clock::time_point now) {
+    if (!batchPending_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    if (now >= batchDeadline_) {
+        EmitBatch();
     }
+}
 
-    return deferred.Promise();
+// How long the I/O thread may sleep without missing a batch deadline
+std::chrono::milliseconds MmsClient::ReportFlushWait(std::chrono::milliseconds wait) {
+    if (!batchPending_.load(std::memory_order_relaxed)) {
+        return wait;
+    }
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    if (!batchPending_) {
+        return wait;
+    }
+    auto untilDeadline = std::chrono::duration_cast<std::chrono::milliseconds>(batchDeadline_ - std::chrono::steady_clock::now());
+    if (untilDeadline < std::chrono::milliseconds(0)) {
+        return std::chrono::milliseconds(0);
+    }
+    return std::min(wait, untilDeadline + std::chrono::milliseconds(1));
 }
 
-Napi::Value MmsClient::GetStatus(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    std::lock_guard<std::mutex> lock(connMutex_);
-    Napi::Object status = Napi::Object::New(env);
-    status.Set("connected", Napi::Boolean::New(env, connected_));
-    status.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-    return status;
+std::shared_ptr<MmsClient::ReportPlan> MmsClient::CompileReportPlan(const std::string& rcbRef, ClientReportControlBlock rcb,
+                                                                   LinkedList dataSetDirectory, ClientDataSet dataSet) {
+    const char* rptId = ClientReportControlBlock_getRptId(rcb);
+    auto plan = std::make_shared<ReportPlan>();
+    plan->client = this;
+    plan->clientID = clientID_;
+    plan->format = format_;
+    plan->convert = convert_;
+    plan->sparse = sparseReports_;
+    plan->journal = (journal_ && ClientReportControlBlock_isBuffered(rcb)) ? journal_.get() : nullptr;
+    plan->rcbRef = rcbRef;
+    plan->rptId = rptId ? rptId : "";  // empty: taken from each report
+    for (LinkedList member = LinkedList_getNext(dataSetDirectory); member != nullptr; member = LinkedList_getNext(member)) {
+        plan->memberRefs.push_back((char*)member->data);
+        if (namedFields_) {
+            plan->memberNames.push_back(MemberFieldNames((char*)member->data));
+        }
+    }
+    plan->dataSetSize = plan->memberRefs.size();
+    if (format_ == ValueFormat::Objects || format_ == ValueFormat::Json) {
+        // The members just read give the types the reports will carry
+        MmsValue* values = dataSet ? ClientDataSet_getValues(dataSet) : nullptr;
+        for (size_t i = 0; i < plan->dataSetSize; i++) {
+            MmsValue* sample = values ? MmsValue_getElement(values, i) : nullptr;
+            plan->members.push_back(DecodePlan::Compile(sample, ValueHint::None,
+                                                        i < plan->memberNames.size() ? plan->memberNames[i] : nullptr));
+        }
+    }
+    return plan;
 }
 
 void MmsClient::ReportCallback(void* parameter, ClientReport report) {
-    MmsClient* client = static_cast<MmsClient*>(parameter);
-    std::string rcbRef = ClientReport_getRcbReference(report) ? ClientReport_getRcbReference(report) : "unknown";
-    std::string rptId = ClientReport_getRptId(report) ? ClientReport_getRptId(report) : "unknown";
+    ReportPlan* plan = static_cast<ReportPlan*>(parameter);
+    MmsClient* client = plan->client;
 
-    printf("Received report for %s with rptId %s, clientID: %s\n", rcbRef.c_str(), rptId.c_str(), client->clientID_.c_str());
-
-    auto it = client->activeReports_.find(rcbRef);
-    if (it == client->activeReports_.end()) {
-        printf("No active report info found for %s, clientID: %s\n", rcbRef.c_str(), client->clientID_.c_str());
-        return;
+    std::string rptId;
+    if (plan->rptId.empty()) {
+        rptId = ClientReport_getRptId(report) ? ClientReport_getRptId(report) : "unknown";
     }
 
-    LinkedList dataSetDirectory = it->second.dataSetDirectory;
+    printf("Received report for %s with rptId %s, clientID: %s\n", plan->rcbRef.c_str(),
+           rptId.empty() ? plan->rptId.c_str() : rptId.c_str(), plan->clientID.c_str());
+
     MmsValue* dataSetValues = ClientReport_getDataSetValues(report);
 
-    std::vector<ResultData> reportValues;
+    // Recorded in the journal only once the report has reached JS
+    std::shared_ptr<ReportAck> ack;
+    if (plan->journal) {
+        MmsValue* entryId = ClientReport_getEntryId(report);
+        if (entryId && MmsValue_getType(entryId) == MMS_OCTET_STRING) {
+            const uint8_t* buffer = MmsValue_getOctetStringBuffer(entryId);
+            ack = std::make_shared<ReportAck>(plan->journal, plan->rcbRef,
+                                              std::vector<uint8_t>(buffer, buffer + MmsValue_getOctetStringSize(entryId)));
+        }
+    }
+
+    std::shared_ptr<FlatMmsValue> reportValues;
+    std::shared_ptr<ColumnarMmsValues> columns;
+    std::shared_ptr<BinaryMmsValues> payload;
     std::vector<int> reasonsForInclusion;
+    std::vector<int> entryIndexes;  // sparseReports only
 
-    if (dataSetDirectory && dataSetValues) {
-        int dataSetSize = LinkedList_size(dataSetDirectory);
+    int dataSetSize = dataSetValues ? static_cast<int>(plan->dataSetSize) : 0;
+    if (plan->format == ValueFormat::Columnar) {
+        columns = std::make_shared<ColumnarMmsValues>(dataSetSize, plan->convert.timestamps);
+        for (int i = 0; i < dataSetSize; i++) {
+            ReasonForInclusion reason = ClientReport_getReasonForInclusion(report, i);
+            columns->SetReason(i, static_cast<uint8_t>(reason));
+            if (reason != IEC61850_REASON_NOT_INCLUDED) {
+                MmsValue* value = MmsValue_getElement(dataSetValues, i);
+                if (value) columns->Set(i, value);
+            }
+        }
+    } else if (plan->format == ValueFormat::Binary) {
+        payload = std::make_shared<BinaryMmsValues>(dataSetSize, true);
         for (int i = 0; i < dataSetSize; i++) {
             ReasonForInclusion reason = ClientReport_getReasonForInclusion(report, i);
-            reasonsForInclusion.push_back(reason);
+            payload->SetReason(i, static_cast<uint8_t>(reason));
+            if (reason != IEC61850_REASON_NOT_INCLUDED) {
+                MmsValue* value = MmsValue_getElement(dataSetValues, i);
+                if (value) payload->Set(i, value);
+            }
+        }
+    } else {
+        reportValues = std::make_shared<FlatMmsValue>(plan->convert);
+        if (!plan->sparse) reasonsForInclusion.reserve(dataSetSize);
+        for (int i = 0; i < dataSetSize; i++) {
+            ReasonForInclusion reason = ClientReport_getReasonForInclusion(report, i);
+            if (!plan->sparse) reasonsForInclusion.push_back(reason);
 
             if (reason != IEC61850_REASON_NOT_INCLUDED) {
                 MmsValue* value = MmsValue_getElement(dataSetValues, i);
-                if (value) {
-                    std::function<ResultData(MmsValue*, const std::string&)> convertMmsValue;
-                    convertMmsValue = [&](MmsValue* val, const std::string& attrName) -> ResultData {
-                        ResultData data = { MmsValue_getType(val), 0.0f, 0, false, "", {}, {}, true, "" };
-                        switch (data.type) {
-                            case MMS_FLOAT:
-                                data.floatValue = MmsValue_toFloat(val);
-                                if (std::isnan(data.floatValue) || std::isinf(data.floatValue)) {
-                                    data.isValid = false;
-                                    data.errorReason = "Invalid float value";
-                                }
-                                break;
-                            case MMS_INTEGER:
-                                data.intValue = MmsValue_toInt32(val);
-                                break;
-                            case MMS_BOOLEAN:
-                                data.boolValue = MmsValue_getBoolean(val);
-                                break;
-                            case MMS_VISIBLE_STRING:
-                                data.stringValue = MmsValue_toString(val) ? MmsValue_toString(val) : "";
-                                break;
-                            case MMS_UTC_TIME: {
-                                uint64_t timestamp = MmsValue_getUtcTimeInMs(val);
-                                time_t time = timestamp / 1000;
-                                char timeStr[64];
-                                strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", gmtime(&time));
-                                data.stringValue = std::string(timeStr) + "." + std::to_string(timestamp % 1000);
-                                } break;
-                            case MMS_BIT_STRING: {
-                                int bitSize = MmsValue_getBitStringSize(val);
-                                char bitStr[128];
-                                snprintf(bitStr, sizeof(bitStr), "BitString(size=%d)", bitSize);
-                                data.stringValue = bitStr;
-                                } break;
-                            case MMS_STRUCTURE: {
-                                int size = MmsValue_getArraySize(val);
-                                for (int j = 0; j < size; j++) {
-                                    MmsValue* element = MmsValue_getElement(val, j);
-                                    if (element) {
-                                        std::string subAttrName = attrName + ".field" + std::to_string(j);
-                                        ResultData subData = convertMmsValue(element, subAttrName);
-                                        if (subData.isValid) data.structureElements.push_back(subData);
-                                    }
-                                }
-                                } break;
-                            case MMS_ARRAY: {
-                                int size = MmsValue_getArraySize(val);
-                                for (int j = 0; j < size; j++) {
-                                    MmsValue* element = MmsValue_getElement(val, j);
-                                    if (element) {
-                                        ResultData subData = convertMmsValue(element, attrName + "[" + std::to_string(j) + "]");
-                                        data.arrayElements.push_back(subData);
-                                    }
-                                }
-                                } break;
-                            case MMS_DATA_ACCESS_ERROR:
-                                data.isValid = false;
-                                data.errorReason = "Data access error";
-                                break;
-                            default:
-                                data.isValid = false;
-                                data.errorReason = "Unsupported type: " + std::to_string(data.type);
-                        }
-                        return data;
-                    };
-                    ResultData resultData = convertMmsValue(value, "reportValue[" + std::to_string(i) + "]");
-                    reportValues.push_back(resultData);
+                if (!value) continue;
+                if (!reportValues->AppendPlanned(value, plan->members[i])) {
+                    // Not the type seen when reporting was enabled (or not plannable)
+                    reportValues->Append(value, ValueHint::None, i < (int)plan->memberNames.size() ? plan->memberNames[i] : nullptr);
+                }
+                if (plan->sparse) {
+                    // One entry per value: its member index and reason
+                    entryIndexes.push_back(i);
+                    reasonsForInclusion.push_back(reason);
                 }
             }
         }
     }
 
     uint64_t timestamp = 0;
+    std::string timeString;
     if (ClientReport_hasTimestamp(report)) {
         timestamp = ClientReport_getTimestamp(report);
+        if (plan->convert.timestamps == TimestampMode::String && plan->format != ValueFormat::Json) {
+            char timeStr[64];
+            timeString.assign(timeStr, FormatUtcTime(timestamp, timeStr, sizeof(timeStr)));
+        }
+    }
+
+    if (plan->format == ValueFormat::Json) {
+        std::string text;
+        JsonWriter json(text);
+        BeginJsonEvent(json, plan->clientID, EventKeys::Text(KEY_REPORT));
+        json.Key(EventKeys::Text(KEY_RCB_REF));
+        json.String(plan->rcbRef);
+        json.Key(EventKeys::Text(KEY_RPT_ID));
+        json.String(rptId.empty() ? plan->rptId : rptId);
+        if (timestamp > 0) {
+            json.Key(EventKeys::Text(KEY_TIMESTAMP));
+            TimestampToJson(json, timestamp * 1000000ULL, plan->convert.timestamps);
+        }
+        if (plan->sparse) {
+            json.Key(EventKeys::Text(KEY_ENTRIES));
+            json.BeginArray();
+            for (size_t i = 0; i < entryIndexes.size(); i++) {
+                json.BeginObject();
+                json.Key(EventKeys::Text(KEY_INDEX));
+                json.Int(entryIndexes[i]);
+                json.Key(EventKeys::Text(KEY_REF));
+                json.String(plan->memberRefs[entryIndexes[i]]);
+                json.Key(EventKeys::Text(KEY_VALUE));
+                reportValues->WriteJson(json, i);
+                json.Key(EventKeys::Text(KEY_REASON));
+                json.Int(reasonsForInclusion[i]);
+                json.EndObject();
+            }
+            json.EndArray();
+        } else {
+            json.Key(EventKeys::Text(KEY_VALUES));
+            json.BeginArray();
+            for (size_t i = 0; i < reportValues->RootCount(); i++) {
+                reportValues->WriteJson(json, i);
+            }
+            json.EndArray();
+            json.Key(EventKeys::Text(KEY_REASONS_FOR_INCLUSION));
+            json.BeginArray();
+            for (int reason : reasonsForInclusion) {
+                json.Int(reason);
+            }
+            json.EndArray();
+        }
+        json.EndObject();
+        client->DeliverReportJson(plan->rcbRef, std::move(text), std::move(ack));
+        return;
     }
 
-    client->tsfn_.NonBlockingCall([client, rcbRef, rptId, reportValues, reasonsForInclusion, timestamp](Napi::Env env, Napi::Function jsCallback) {
+    std::shared_ptr<const ReportPlan> rcb = plan->shared_from_this();
+    client->DeliverReport(plan->rcbRef, [client, rcb, rptId, reportValues, columns, payload, reasonsForInclusion, entryIndexes, timestamp, timeString](Napi::Env env) {
         Napi::Object eventObj = Napi::Object::New(env);
-        eventObj.Set("clientID", Napi::String::New(env, client->clientID_.c_str()));
-        eventObj.Set("type", Napi::String::New(env, "data"));
-        eventObj.Set("event", Napi::String::New(env, "report"));
-        eventObj.Set("rcbRef", Napi::String::New(env, rcbRef));
-        eventObj.Set("rptId", Napi::String::New(env, rptId));
+        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), client->ClientIdValue(env));
+        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_DATA));
+        eventObj.Set(EventKeys::Get(env, KEY_EVENT), EventKeys::Get(env, KEY_REPORT));
+        eventObj.Set(EventKeys::Get(env, KEY_RCB_REF), Napi::String::New(env, rcb->rcbRef));
+        eventObj.Set(EventKeys::Get(env, KEY_RPT_ID), Napi::String::New(env, rptId.empty() ? rcb->rptId : rptId));
 
         if (timestamp > 0) {
-            time_t time = timestamp / 1000;
-            char timeStr[64];
-            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", gmtime(&time));
-            std::string timeString = std::string(timeStr) + "." + std::to_string(timestamp % 1000);
-            eventObj.Set("timestamp", Napi::String::New(env, timeString));
-        }
-
-        Napi::Array valuesArray = Napi::Array::New(env, reportValues.size());
-        std::function<Napi::Value(const ResultData&)> toNapiValue = [&](const ResultData& data) -> Napi::Value {
-            if (!data.isValid) return Napi::String::New(env, data.errorReason);
-            switch (data.type) {
-                case MMS_FLOAT: return Napi::Number::New(env, data.floatValue);
-                case MMS_INTEGER: return Napi::Number::New(env, data.intValue);
-                case MMS_BOOLEAN: return Napi::Boolean::New(env, data.boolValue);
-                case MMS_VISIBLE_STRING: case MMS_UTC_TIME: case MMS_BIT_STRING: return Napi::String::New(env, data.stringValue);
-                case MMS_STRUCTURE: {
-                    Napi::Object structObj = Napi::Object::New(env);
-                    for (size_t i = 0; i < data.structureElements.size(); i++)
-                        structObj.Set(Napi::String::New(env, "field" + std::to_string(i)), toNapiValue(data.structureElements[i]));
-                    return structObj;
-                }
-                case MMS_ARRAY: {
-                    Napi::Array array = Napi::Array::New(env, data.arrayElements.size());
-                    for (size_t i = 0; i < data.arrayElements.size(); i++)
-                        array.Set(uint32_t(i), toNapiValue(data.arrayElements[i]));
-                    return array;
-                }
-                default: return Napi::String::New(env, "Unsupported type");
+            if (timeString.empty()) {
+                eventObj.Set(EventKeys::Get(env, KEY_TIMESTAMP), TimestampToNapi(env, timestamp * 1000000ULL, rcb->convert.timestamps));
+            } else {
+                eventObj.Set(EventKeys::Get(env, KEY_TIMESTAMP), Napi::String::New(env, timeString));
+            }
+        }
+
+        if (columns) {
+            eventObj.Set(EventKeys::Get(env, KEY_COLUMNS), columns->ToNapi(env, true));
+            return eventObj;
+        }
+        if (payload) {
+            eventObj.Set(EventKeys::Get(env, KEY_PAYLOAD), payload->ToNapi(env));
+            return eventObj;
+        }
+
+        if (rcb->sparse) {
+            Napi::Array entries = Napi::Array::New(env, entryIndexes.size());
+            for (size_t i = 0; i < entryIndexes.size(); i++) {
+                Napi::Object entry = Napi::Object::New(env);
+                entry.Set(EventKeys::Get(env, KEY_INDEX), Napi::Number::New(env, entryIndexes[i]));
+                entry.Set(EventKeys::Get(env, KEY_REF), EventKeys::Name(env, rcb->memberRefs[entryIndexes[i]]));
+                entry.Set(EventKeys::Get(env, KEY_VALUE), reportValues->ToNapi(env, i));
+                entry.Set(EventKeys::Get(env, KEY_REASON), Napi::Number::New(env, reasonsForInclusion[i]));
+                entries.Set(uint32_t(i), entry);
             }
-        };
-        for (size_t i = 0; i < reportValues.size(); i++) {
-            valuesArray.Set(uint32_t(i), toNapiValue(reportValues[i]));
+            eventObj.Set(EventKeys::Get(env, KEY_ENTRIES), entries);
+            return eventObj;
+        }
+
+        Napi::Array valuesArray = Napi::Array::New(env, reportValues->RootCount());
+        for (size_t i = 0; i < reportValues->RootCount(); i++) {
+            valuesArray.Set(uint32_t(i), reportValues->ToNapi(env, i));
         }
-        eventObj.Set("values", valuesArray);
+        eventObj.Set(EventKeys::Get(env, KEY_VALUES), valuesArray);
 
         Napi::Array reasonsArray = Napi::Array::New(env, reasonsForInclusion.size());
         for (size_t i = 0; i < reasonsForInclusion.size(); i++) {
             reasonsArray.Set(uint32_t(i), Napi::Number::New(env, reasonsForInclusion[i]));
         }
-        eventObj.Set("reasonsForInclusion", reasonsArray);
+        eventObj.Set(EventKeys::Get(env, KEY_REASONS_FOR_INCLUSION), reasonsArray);
 
-        jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-    });
+        return eventObj;
+    }, std::move(ack));
+}
+
+bool MmsClient::ResumeBufferedReport(const std::string& rcbRef, ClientReportControlBlock rcb) {
+    std::vector<uint8_t> entryId;
+    if (!journal_ || !ClientReportControlBlock_isBuffered(rcb)) {
+        return false;
+    }
+    // Reporting starts over from the journaled point (or a GI), which covers reports dropped so far
+    journal_->Thaw(rcbRef);
+    if (!journal_->Get(rcbRef, entryId)) {
+        return false;
+    }
+    MmsValue* value = MmsValue_newOctetString(entryId.size(), entryId.size());
+    MmsValue_setOctetString(value, entryId.data(), entryId.size());
+    ClientReportControlBlock_setEntryId(rcb, value);
+    MmsValue_delete(value);
+
+    // Written on its own while the RCB is disabled; the IED rejects an EntryID it no longer buffers
+    IedClientError error;
+    IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_ENTRY_ID, true);
+    if (error != IED_ERROR_OK) {
+        printf("ResumeBufferedReport: EntryID not accepted for %s, error: %d, starting with GI, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+        return false;
+    }
+    printf("ResumeBufferedReport: Resuming %s after the journaled EntryID, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
+    return true;
+}
+
+// A new association starts with every RCB disabled. The handlers are still installed, so only
+// the RCB values are written again.
+void MmsClient::RearmReports() {
+    for (auto& [rcbRef, reportInfo] : activeReports_) {
+        if (!connected_) {
+            return;
+        }
+        if (!reportInfo.rcb) {
+            continue;
+        }
+        bool resumed = ResumeBufferedReport(rcbRef, reportInfo.rcb);
+        ClientReportControlBlock_setRptEna(reportInfo.rcb, true);
+        ClientReportControlBlock_setGI(reportInfo.rcb, !resumed);
+        IedClientError error;
+        IedConnection_setRCBValues(connection_, &error, reportInfo.rcb,
+                                   RCB_ELEMENT_TRG_OPS | RCB_ELEMENT_RPT_ENA | RCB_ELEMENT_INTG_PD | (resumed ? 0 : RCB_ELEMENT_GI), true);
+        if (error != IED_ERROR_OK) {
+            printf("RearmReports: Failed to enable reporting for %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+            std::string rcbRefCopy = rcbRef;
+            tsfn_.NonBlockingCall([this, rcbRefCopy, error](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to re-enable reporting for " + rcbRefCopy + " after reconnect, error: " + std::to_string(error)));
+                eventObj.Set(EventKeys::Get(env, KEY_RCB_REF), Napi::String::New(env, rcbRefCopy));
+                jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            continue;
+        }
+        printf("RearmReports: Re-enabled reporting for %s%s, clientID: %s\n", rcbRef.c_str(), resumed ? " (resumed)" : "", clientID_.c_str());
+        std::string rcbRefCopy = rcbRef;
+        tsfn_.NonBlockingCall([this, rcbRefCopy, resumed](Napi::Env env, Napi::Function jsCallback) {
+            Napi::Object eventObj = Napi::Object::New(env);
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+            eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "reportingEnabled"));
+            eventObj.Set(EventKeys::Get(env, KEY_RCB_REF), Napi::String::New(env, rcbRefCopy));
+            eventObj.Set("resumed", Napi::Boolean::New(env, resumed));
+            jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+        });
+    }
 }
 
 Napi::Value MmsClient::EnableReporting(const Napi::CallbackInfo& info) {
@@ -1951,35 +3460,69 @@ Napi::Value MmsClient::EnableReporting(const Napi::CallbackInfo& info) {
     std::string rcbRef = info[0].As<Napi::String>().Utf8Value();
     std::string datasetRef = info[1].As<Napi::String>().Utf8Value();
 
-    std::lock_guard<std::mutex> lock(connMutex_);
+    ReplyPtr reply = NewReply(env);
     if (!connected_) {
         printf("EnableReporting: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+        return Fail(env, reply, "Not connected");
     }
 
+    Post(CommandQueue::LANE_REPORTS, [this, reply, rcbRef, datasetRef]() {
+        StartReporting(reply, rcbRef, datasetRef);
+    });
+    return ReplyValue(env, reply);
+}
+
+// Enables reporting on rcbRef for datasetRef and settles reply (I/O thread). Shared by
+// enableReporting() and reserveReport() once it has reserved an instance. On failure, onFailure
+// runs before the reply is settled.
+void MmsClient::StartReporting(ReplyPtr reply, const std::string& rcbRef, const std::string& datasetRef,
+                               const std::function<void()>& onFailure) {
+    if (!connected_) {
+        printf("EnableReporting: Not connected, clientID: %s\n", clientID_.c_str());
+        if (onFailure) onFailure();
+        tsfn_.NonBlockingCall([this, reply](Napi::Env env, Napi::Function jsCallback) {
+            Napi::Object eventObj = Napi::Object::New(env);
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+            eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+        });
+        return;
+    }
     try {
         IedClientError error;
 
         // Check if report is already enabled
         if (activeReports_.find(rcbRef) != activeReports_.end()) {
             printf("EnableReporting: Report already enabled for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
-            Napi::Error::New(env, "Report already enabled for " + rcbRef).ThrowAsJavaScriptException();
-            return env.Undefined();
+            if (onFailure) onFailure();
+            tsfn_.NonBlockingCall([this, reply, rcbRef](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Report already enabled for " + rcbRef));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
         }
 
         // Read dataset directory
         LinkedList dataSetDirectory = IedConnection_getDataSetDirectory(connection_, &error, datasetRef.c_str(), nullptr);
         if (error != IED_ERROR_OK || dataSetDirectory == nullptr) {
             printf("EnableReporting: Failed to read dataset directory for %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
-            tsfn_.NonBlockingCall([this, datasetRef, error](Napi::Env env, Napi::Function jsCallback) {
+            if (onFailure) onFailure();
+            tsfn_.NonBlockingCall([this, reply, datasetRef, error](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to read dataset directory for " + datasetRef + ", error: " + std::to_string(error)));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to read dataset directory for " + datasetRef + ", error: " + std::to_string(error)));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
+        }
+
+        for (LinkedList member = LinkedList_getNext(dataSetDirectory); member != nullptr; member = LinkedList_getNext(member)) {
+            RememberMemberFc((char*)member->data);
         }
 
         // Read dataset
@@ -1987,14 +3530,15 @@ Napi::Value MmsClient::EnableReporting(const Napi::CallbackInfo& info) {
         if (error != IED_ERROR_OK || clientDataSet == nullptr) {
             printf("EnableReporting: Failed to read dataset %s, error: %d, clientID: %s\n", datasetRef.c_str(), error, clientID_.c_str());
             LinkedList_destroy(dataSetDirectory);
-            tsfn_.NonBlockingCall([this, datasetRef, error](Napi::Env env, Napi::Function jsCallback) {
+            if (onFailure) onFailure();
+            tsfn_.NonBlockingCall([this, reply, datasetRef, error](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to read dataset " + datasetRef + ", error: " + std::to_string(error)));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to read dataset " + datasetRef + ", error: " + std::to_string(error)));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
         }
 
         // Read RCB values
@@ -2003,14 +3547,15 @@ Napi::Value MmsClient::EnableReporting(const Napi::CallbackInfo& info) {
             printf("EnableReporting: Failed to get RCB values for %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
             LinkedList_destroy(dataSetDirectory);
             ClientDataSet_destroy(clientDataSet);
-            tsfn_.NonBlockingCall([this, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
+            if (onFailure) onFailure();
+            tsfn_.NonBlockingCall([this, reply, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to get RCB values for " + rcbRef + ", error: " + std::to_string(error)));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to get RCB values for " + rcbRef + ", error: " + std::to_string(error)));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
         }
 
         // Configure RCB
@@ -2019,49 +3564,59 @@ Napi::Value MmsClient::EnableReporting(const Napi::CallbackInfo& info) {
         std::string datasetRefMms = datasetRef;
         //std::replace(datasetRefMms.begin(), datasetRefMms.end(), '.', '$');
         ClientReportControlBlock_setDataSetReference(rcb, datasetRefMms.c_str());
-        ClientReportControlBlock_setRptEna(rcb, true);
         ClientReportControlBlock_setIntgPd(rcb, 3000);
-        ClientReportControlBlock_setGI(rcb, true);
 
         // Install report handler
-        IedConnection_installReportHandler(connection_, rcbRef.c_str(), ClientReportControlBlock_getRptId(rcb), ReportCallback, this);
+        std::shared_ptr<ReportPlan> plan = CompileReportPlan(rcbRef, rcb, dataSetDirectory, clientDataSet);
+        IedConnection_installReportHandler(connection_, rcbRef.c_str(), ClientReportControlBlock_getRptId(rcb), ReportCallback, plan.get());
+
+        // A resumed buffered RCB replays what was missed, a GI would only repeat the data set
+        bool resumed = ResumeBufferedReport(rcbRef, rcb);
+        ClientReportControlBlock_setRptEna(rcb, true);
+        ClientReportControlBlock_setGI(rcb, !resumed);
 
         // Write RCB parameters
-        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_TRG_OPS | RCB_ELEMENT_RPT_ENA | RCB_ELEMENT_GI | RCB_ELEMENT_INTG_PD, true);
+        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_TRG_OPS | RCB_ELEMENT_RPT_ENA | RCB_ELEMENT_INTG_PD | (resumed ? 0 : RCB_ELEMENT_GI), true);
         if (error != IED_ERROR_OK) {
             printf("EnableReporting: Failed to set RCB values for %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+            IedConnection_uninstallReportHandler(connection_, rcbRef.c_str());
             ClientReportControlBlock_destroy(rcb);
             LinkedList_destroy(dataSetDirectory);
             ClientDataSet_destroy(clientDataSet);
-            tsfn_.NonBlockingCall([this, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
+            if (onFailure) onFailure();
+            tsfn_.NonBlockingCall([this, reply, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to set RCB values for " + rcbRef + ", error: " + std::to_string(error)));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to set RCB values for " + rcbRef + ", error: " + std::to_string(error)));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
         }
 
         //Thread_sleep(1000);
 
         /* Trigger GI Report */
-        ClientReportControlBlock_setGI(rcb, true);
-        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_GI, true);
+        if (!resumed) {
+            ClientReportControlBlock_setGI(rcb, true);
+            IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_GI, true);
+        }
 
          if (error != IED_ERROR_OK) {
             printf("EnableReporting: Failed to set RCB value RCB_ELEMENT_GI for %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+            IedConnection_uninstallReportHandler(connection_, rcbRef.c_str());
             ClientReportControlBlock_destroy(rcb);
             LinkedList_destroy(dataSetDirectory);
             ClientDataSet_destroy(clientDataSet);
-            tsfn_.NonBlockingCall([this, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
+            if (onFailure) onFailure();
+            tsfn_.NonBlockingCall([this, reply, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
                 Napi::Object eventObj = Napi::Object::New(env);
-                eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                eventObj.Set("type", Napi::String::New(env, "error"));
-                eventObj.Set("reason", Napi::String::New(env, "Failed to set RCB value RCB_ELEMENT_GI for " + rcbRef + ", error: " + std::to_string(error)));
-                jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to set RCB value RCB_ELEMENT_GI for " + rcbRef + ", error: " + std::to_string(error)));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
             });
-            return env.Undefined();
+            return;
         }
 
         // Store report info
@@ -2070,104 +3625,365 @@ Napi::Value MmsClient::EnableReporting(const Napi::CallbackInfo& info) {
         reportInfo.dataSet = clientDataSet;
         reportInfo.dataSetDirectory = dataSetDirectory;
         reportInfo.rcbRef = rcbRef;
+        reportInfo.plan = plan;
         activeReports_[rcbRef] = reportInfo;
 
         printf("EnableReporting: Successfully enabled reporting for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, rcbRef](Napi::Env env, Napi::Function jsCallback) {
+        tsfn_.NonBlockingCall([this, reply, rcbRef, resumed](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "control"));
-            eventObj.Set("event", Napi::String::New(env, "reportingEnabled"));
-            eventObj.Set("rcbRef", Napi::String::New(env, rcbRef));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+            eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "reportingEnabled"));
+            eventObj.Set(EventKeys::Get(env, KEY_RCB_REF), Napi::String::New(env, rcbRef));
+            eventObj.Set("resumed", Napi::Boolean::New(env, resumed));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         });
 
-        return env.Undefined();
+        return;
     } catch (const std::exception& e) {
         printf("EnableReporting: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
+        if (onFailure) onFailure();
+        tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in EnableReporting: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+            eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Exception in EnableReporting: ") + e.what()));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         });
-        return env.Undefined();
+        return;
     }
 }
 
-Napi::Value MmsClient::DisableReporting(const Napi::CallbackInfo& info) {
+// reserveReport(baseRcbRef, datasetRef, { first, count, digits }): probes the instances
+// baseRcbRef + first .. baseRcbRef + (first + count - 1), index zero padded to digits
+Napi::Value MmsClient::ReserveReport(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Expected rcbRef (string)").ThrowAsJavaScriptException();
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Expected baseRcbRef (string) and datasetRef (string)").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    std::string rcbRef = info[0].As<Napi::String>().Utf8Value();
+    std::string baseRcbRef = info[0].As<Napi::String>().Utf8Value();
+    std::string datasetRef = info[1].As<Napi::String>().Utf8Value();
+    int first = 1;
+    int count = 10;
+    int digits = 2;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object options = info[2].As<Napi::Object>();
+        if (options.Has("first") && options.Get("first").IsNumber()) {
+            first = options.Get("first").As<Napi::Number>().Int32Value();
+        }
+        if (options.Has("count") && options.Get("count").IsNumber()) {
+            count = options.Get("count").As<Napi::Number>().Int32Value();
+        }
+        if (options.Has("digits") && options.Get("digits").IsNumber()) {
+            digits = options.Get("digits").As<Napi::Number>().Int32Value();
+        }
+    }
+    if (first < 0 || count < 1 || count > 100 || digits < 1 || digits > 4) {
+        Napi::RangeError::New(env, "Expected first >= 0, count between 1 and 100 and digits between 1 and 4").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto reservation = std::make_shared<ReportReservation>();
+    reservation->datasetRef = datasetRef;
+    for (int i = 0; i < count; i++) {
+        char index[16];
+        snprintf(index, sizeof(index), "%0*d", digits, first + i);
+        reservation->rcbRefs.push_back(baseRcbRef + index);
+    }
+    reservation->rcbs.assign(reservation->rcbRefs.size(), nullptr);
+    reservation->pending = reservation->rcbRefs.size();
 
-    std::lock_guard<std::mutex> lock(connMutex_);
+    ReplyPtr reply = NewReply(env);
+    reservation->reply = reply;
     if (!connected_) {
-        printf("DisableReporting: Not connected, clientID: %s\n", clientID_.c_str());
-        Napi::Error::New(env, "Not connected").ThrowAsJavaScriptException();
-        return env.Undefined();
+        printf("ReserveReport: Not connected, clientID: %s\n", clientID_.c_str());
+        return Fail(env, reply, "Not connected");
     }
 
-    try {
-        auto it = activeReports_.find(rcbRef);
-        if (it == activeReports_.end()) {
-            printf("DisableReporting: No active report found for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
-            Napi::Error::New(env, "No active report for " + rcbRef).ThrowAsJavaScriptException();
-            return env.Undefined();
+    Post(CommandQueue::LANE_REPORTS, [this, reservation]() {
+        if (!connected_) {
+            printf("ReserveReport: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply = reservation->reply](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
         }
+        // One read per instance, outstanding together instead of one round trip each. They go
+        // through the pipeline window in every mode, which ApplyNegotiatedWindow() keeps one call
+        // below the server's maxServOutstandingCalling, so the blocking commands that run while
+        // they are outstanding still find a free call; the rest wait in the backlog.
+        for (size_t i = 0; i < reservation->rcbRefs.size(); i++) {
+            PendingRcbRead* read = new PendingRcbRead{this, reservation, i};
+            SubmitPipelined([this, read]() { SendRcbRead(read); });
+        }
+    });
+    return ReplyValue(env, reply);
+}
 
-        ReportInfo& reportInfo = it->second;
-        if (reportInfo.rcb) {
-            ClientReportControlBlock_setRptEna(reportInfo.rcb, false);
-            IedClientError error;
-            IedConnection_setRCBValues(connection_, &error, reportInfo.rcb, RCB_ELEMENT_RPT_ENA, true);
-            if (error != IED_ERROR_OK) {
-                printf("DisableReporting: Failed to disable reporting for %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
-                tsfn_.NonBlockingCall([this, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
-                    Napi::Object eventObj = Napi::Object::New(env);
-                    eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-                    eventObj.Set("type", Napi::String::New(env, "error"));
-                    eventObj.Set("reason", Napi::String::New(env, "Failed to disable reporting for " + rcbRef + ", error: " + std::to_string(error)));
-                    jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-                });
+void MmsClient::SendRcbRead(PendingRcbRead* read) {
+    IedClientError error;
+    IedConnection_getRCBValuesAsync(connection_, &error, read->reservation->rcbRefs[read->index].c_str(), nullptr, GetRCBValuesHandler, read);
+    if (error != IED_ERROR_OK) {
+        // Not sent, the handler will not be called by the library
+        GetRCBValuesHandler(0, read, error, nullptr);
+    }
+}
+
+// Called on the library's receive thread; the RCB values are collected on the I/O thread
+void MmsClient::GetRCBValuesHandler(uint32_t invokeId, void* parameter, IedClientError err, ClientReportControlBlock rcb) {
+    PendingRcbRead* read = static_cast<PendingRcbRead*>(parameter);
+    MmsClient* client = read->client;
+    client->Post([client, read, err, rcb]() {
+        ReportReservation& reservation = *read->reservation;
+        if (err == IED_ERROR_OUTSTANDING_CALL_LIMIT_REACHED) {
+            // Says nothing about the instance: read it again once another call has finished
+            if (rcb != nullptr) {
+                ClientReportControlBlock_destroy(rcb);
             }
-            ClientReportControlBlock_destroy(reportInfo.rcb);
-            reportInfo.rcb = nullptr;
+            printf("ReserveReport: Outstanding call limit reached at %d calls, requeueing %s, clientID: %s\n",
+                   client->inFlight_.load(), reservation.rcbRefs[read->index].c_str(), client->clientID_.c_str());
+            client->RetryPipelined([client, read]() { client->SendRcbRead(read); });
+            return;
         }
-        if (reportInfo.dataSet) {
-            ClientDataSet_destroy(reportInfo.dataSet);
-            reportInfo.dataSet = nullptr;
+        client->CompletePipelined();
+        if (err == IED_ERROR_OK && rcb != nullptr) {
+            reservation.rcbs[read->index] = rcb;
+        } else {
+            // Either way the instance cannot be reserved; only the first kind means it does not exist
+            bool missing = (err == IED_ERROR_OBJECT_DOES_NOT_EXIST || err == IED_ERROR_OBJECT_REFERENCE_INVALID ||
+                            err == IED_ERROR_OBJECT_UNDEFINED);
+            printf("ReserveReport: %s %s, error: %d, clientID: %s\n", missing ? "No such RCB" : "Failed to read RCB values of",
+                   reservation.rcbRefs[read->index].c_str(), err, client->clientID_.c_str());
+            if (!missing) {
+                reservation.unreadable++;
+            }
+            if (rcb != nullptr) {
+                ClientReportControlBlock_destroy(rcb);
+            }
         }
-        if (reportInfo.dataSetDirectory) {
-            LinkedList_destroy(reportInfo.dataSetDirectory);
-            reportInfo.dataSetDirectory = nullptr;
+        if (--reservation.pending == 0) {
+            client->CompleteReservation(read->reservation);
         }
+        delete read;
+    });
+}
 
-        activeReports_.erase(it);
-        printf("DisableReporting: Successfully disabled reporting for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, rcbRef](Napi::Env env, Napi::Function jsCallback) {
-            Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "control"));
-            eventObj.Set("event", Napi::String::New(env, "reportingDisabled"));
-            eventObj.Set("rcbRef", Napi::String::New(env, rcbRef));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
-        });
+// An RCB is free when it is not enabled, not reserved and has no owner
+static bool IsRcbFree(ClientReportControlBlock rcb) {
+    if (ClientReportControlBlock_getRptEna(rcb)) {
+        return false;
+    }
+    if (ClientReportControlBlock_isBuffered(rcb)) {
+        if (ClientReportControlBlock_hasResvTms(rcb) && ClientReportControlBlock_getResvTms(rcb) != 0) {
+            return false;
+        }
+    } else if (ClientReportControlBlock_getResv(rcb)) {
+        return false;
+    }
+    MmsValue* owner = ClientReportControlBlock_getOwner(rcb);
+    if (owner != nullptr && MmsValue_getType(owner) == MMS_OCTET_STRING) {
+        const uint8_t* buffer = MmsValue_getOctetStringBuffer(owner);
+        for (int i = 0; i < MmsValue_getOctetStringSize(owner); i++) {
+            if (buffer[i] != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
-        return env.Undefined();
-    } catch (const std::exception& e) {
-        printf("DisableReporting: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
-        tsfn_.NonBlockingCall([this, e](Napi::Env env, Napi::Function jsCallback) {
+// The reservation write is the atomic step: of two clients that both found the instance free,
+// the IED grants it to the first and rejects the second, which moves on to the next instance.
+bool MmsClient::ReserveRcb(const std::string& rcbRef, ClientReportControlBlock rcb) {
+    IedClientError error;
+    if (ClientReportControlBlock_isBuffered(rcb)) {
+        if (!ClientReportControlBlock_hasResvTms(rcb)) {
+            // Edition 1 BRCB: enabling it is what takes it
+            return true;
+        }
+        ClientReportControlBlock_setResvTms(rcb, RESERVATION_TIME);
+        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_RESV_TMS, true);
+    } else {
+        ClientReportControlBlock_setResv(rcb, true);
+        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_RESV, true);
+    }
+    if (error != IED_ERROR_OK) {
+        printf("ReserveReport: Reservation of %s refused, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+        return false;
+    }
+    printf("ReserveReport: Reserved %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
+    return true;
+}
+
+// Gives the reservation of ReserveRcb() back
+void MmsClient::ReleaseRcb(const std::string& rcbRef, ClientReportControlBlock rcb) {
+    IedClientError error;
+    if (ClientReportControlBlock_isBuffered(rcb)) {
+        if (!ClientReportControlBlock_hasResvTms(rcb)) {
+            return;
+        }
+        ClientReportControlBlock_setResvTms(rcb, 0);
+        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_RESV_TMS, true);
+    } else {
+        ClientReportControlBlock_setResv(rcb, false);
+        IedConnection_setRCBValues(connection_, &error, rcb, RCB_ELEMENT_RESV, true);
+    }
+    if (error != IED_ERROR_OK) {
+        printf("ReserveReport: Failed to release %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+        return;
+    }
+    printf("ReserveReport: Released %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
+}
+
+void MmsClient::CompleteReservation(const std::shared_ptr<ReportReservation>& reservation) {
+    std::string reserved;
+    ClientReportControlBlock reservedRcb = nullptr;
+    for (size_t i = 0; i < reservation->rcbs.size(); i++) {
+        ClientReportControlBlock rcb = reservation->rcbs[i];
+        if (rcb == nullptr) {
+            continue;
+        }
+        reservation->rcbs[i] = nullptr;
+        const std::string& rcbRef = reservation->rcbRefs[i];
+        if (reserved.empty() && connected_ && activeReports_.find(rcbRef) == activeReports_.end() &&
+            IsRcbFree(rcb) && ReserveRcb(rcbRef, rcb)) {
+            // Kept for ReleaseRcb() in case enabling fails
+            reserved = rcbRef;
+            reservedRcb = rcb;
+            continue;
+        }
+        ClientReportControlBlock_destroy(rcb);
+    }
+
+    if (reserved.empty()) {
+        std::string reason;
+        if (!connected_) {
+            reason = "Not connected";
+        } else {
+            reason = "No free report control block among " + reservation->rcbRefs.front() + " .. " + reservation->rcbRefs.back();
+            if (reservation->unreadable > 0) {
+                reason += ", " + std::to_string(reservation->unreadable) + " could not be read";
+            }
+        }
+        printf("ReserveReport: %s, clientID: %s\n", reason.c_str(), clientID_.c_str());
+        tsfn_.NonBlockingCall([this, reply = reservation->reply, reason](Napi::Env env, Napi::Function jsCallback) {
             Napi::Object eventObj = Napi::Object::New(env);
-            eventObj.Set("clientID", Napi::String::New(env, clientID_.c_str()));
-            eventObj.Set("type", Napi::String::New(env, "error"));
-            eventObj.Set("reason", Napi::String::New(env, std::string("Exception in DisableReporting: ") + e.what()));
-            jsCallback.Call({Napi::String::New(env, "data"), eventObj});
+            eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+            eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+            eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, reason));
+            if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
         });
+        return;
+    }
+    // Settles the reply with reportingEnabled, whose rcbRef names the reserved instance. If enabling
+    // fails, the reservation is given back before the reply is rejected.
+    StartReporting(reservation->reply, reserved, reservation->datasetRef, [this, &reserved, reservedRcb]() {
+        ReleaseRcb(reserved, reservedRcb);
+    });
+    ClientReportControlBlock_destroy(reservedRcb);
+}
+
+Napi::Value MmsClient::DisableReporting(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected rcbRef (string)").ThrowAsJavaScriptException();
         return env.Undefined();
     }
-}
\ No newline at end of file
+
+    std::string rcbRef = info[0].As<Napi::String>().Utf8Value();
+
+    ReplyPtr reply = NewReply(env);
+    if (!connected_) {
+        printf("DisableReporting: Not connected, clientID: %s\n", clientID_.c_str());
+        return Fail(env, reply, "Not connected");
+    }
+
+    Post(CommandQueue::LANE_REPORTS, [this, reply, rcbRef]() {
+        if (!connected_) {
+            printf("DisableReporting: Not connected, clientID: %s\n", clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Not connected"));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+        try {
+            auto it = activeReports_.find(rcbRef);
+            if (it == activeReports_.end()) {
+                printf("DisableReporting: No active report found for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
+                tsfn_.NonBlockingCall([this, reply, rcbRef](Napi::Env env, Napi::Function jsCallback) {
+                    Napi::Object eventObj = Napi::Object::New(env);
+                    eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                    eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                    eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "No active report for " + rcbRef));
+                    if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                });
+                return;
+            }
+
+            ReportInfo& reportInfo = it->second;
+            // Waits for a report being handled, the plan is released with the report info
+            IedConnection_uninstallReportHandler(connection_, rcbRef.c_str());
+            if (reportInfo.rcb) {
+                ClientReportControlBlock_setRptEna(reportInfo.rcb, false);
+                IedClientError error;
+                IedConnection_setRCBValues(connection_, &error, reportInfo.rcb, RCB_ELEMENT_RPT_ENA, true);
+                if (error != IED_ERROR_OK) {
+                    printf("DisableReporting: Failed to disable reporting for %s, error: %d, clientID: %s\n", rcbRef.c_str(), error, clientID_.c_str());
+                    tsfn_.NonBlockingCall([this, reply, rcbRef, error](Napi::Env env, Napi::Function jsCallback) {
+                        Napi::Object eventObj = Napi::Object::New(env);
+                        eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                        eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                        eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, "Failed to disable reporting for " + rcbRef + ", error: " + std::to_string(error)));
+                        if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+                    });
+                }
+                ClientReportControlBlock_destroy(reportInfo.rcb);
+                reportInfo.rcb = nullptr;
+            }
+            if (reportInfo.dataSet) {
+                ClientDataSet_destroy(reportInfo.dataSet);
+                reportInfo.dataSet = nullptr;
+            }
+            if (reportInfo.dataSetDirectory) {
+                LinkedList_destroy(reportInfo.dataSetDirectory);
+                reportInfo.dataSetDirectory = nullptr;
+            }
+
+            activeReports_.erase(it);
+            // The EntryID stays journaled, enabling the RCB again resumes after it
+            if (journal_) journal_->Flush();
+            printf("DisableReporting: Successfully disabled reporting for %s, clientID: %s\n", rcbRef.c_str(), clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply, rcbRef](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_CONTROL));
+                eventObj.Set(EventKeys::Get(env, KEY_EVENT), Napi::String::New(env, "reportingDisabled"));
+                eventObj.Set(EventKeys::Get(env, KEY_RCB_REF), Napi::String::New(env, rcbRef));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+
+            return;
+        } catch (const std::exception& e) {
+            printf("DisableReporting: Exception occurred: %s, clientID: %s\n", e.what(), clientID_.c_str());
+            tsfn_.NonBlockingCall([this, reply, e](Napi::Env env, Napi::Function jsCallback) {
+                Napi::Object eventObj = Napi::Object::New(env);
+                eventObj.Set(EventKeys::Get(env, KEY_CLIENT_ID), ClientIdValue(env));
+                eventObj.Set(EventKeys::Get(env, KEY_TYPE), EventKeys::Get(env, KEY_ERROR));
+                eventObj.Set(EventKeys::Get(env, KEY_REASON), Napi::String::New(env, std::string("Exception in DisableReporting: ") + e.what()));
+                if (!Settle(reply, env, eventObj)) jsCallback.Call({EventKeys::Get(env, KEY_DATA), eventObj});
+            });
+            return;
+        }
+    });
+    return ReplyValue(env, reply);
+}
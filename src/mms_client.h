@@ -9,6 +9,8 @@
 #include <atomic>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <deque>
 #include <iec61850_client.h>
 
 class MmsClient : public Napi::ObjectWrap<MmsClient> {
@@ -48,9 +50,20 @@ private:
 #include <atomic>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <deque>
+#include <functional>
+#include <chrono>
+#include <memory>
+#include <uv.h>
 #include <iec61850_client.h>
+#include "command_queue.h"
+#include "connection_loop.h"
+#include "mms_value_converter.h"
+#include "event_queue.h"
+#include "report_journal.h"
 
-class MmsClient : public Napi::ObjectWrap<MmsClient> {
+class MmsClient : public Napi::ObjectWrap<MmsClient>, public LoopClient {
 public:
     static Napi::Object Init(Napi::Env env, Napi::Object exports);
     MmsClient(const Napi::CallbackInfo& info);
@@ -61,6 +74,7 @@ private:
 
      Napi::Value Connect(const Napi::CallbackInfo& info);
     Napi::Value ReadData(const Napi::CallbackInfo& info);
+    Napi::Value ReadMany(const Napi::CallbackInfo& info);
     Napi::Value Close(const Napi::CallbackInfo& info);
     Napi::Value GetStatus(const Napi::CallbackInfo& info);
     Napi::Value GetLogicalDevices(const Napi::CallbackInfo& info);
@@ -74,39 +88,295 @@ private:
     Napi::Value BrowseDataModel(const Napi::CallbackInfo& info);
 
     Napi::Value EnableReporting(const Napi::CallbackInfo& info);
-    Napi::Value DisableReporting(const Napi::CallbackInfo& info);     
+    Napi::Value DisableReporting(const Napi::CallbackInfo& info);
+    Napi::Value ReserveReport(const Napi::CallbackInfo& info);
 
     static void ReportCallback(void* parameter, ClientReport report);
+
+    // Report delivery, optionally batched (constructor option reportBatch: { maxReports,
+    // maxLatencyMs }): a batch is one 'reports' event, or one NDJSON string with format 'json'
+    using ReportEvent = std::function<Napi::Object(Napi::Env)>;  // builds the event on the JS thread
+    void DeliverReport(const std::string& rcbRef, ReportEvent event, std::shared_ptr<ReportAck> ack);
+    void DeliverReportJson(const std::string& rcbRef, std::string text, std::shared_ptr<ReportAck> ack);
+    void OpenBatch();
+    void EmitBatch();
+    void FlushReports();
+    void FlushReportsIfDue(std::chrono::steady_clock::time_point now);
+    std::chrono::milliseconds ReportFlushWait(std::chrono::milliseconds wait);
+
+    // Promise-only mode (constructor option { promiseOnly: true }): every request settles the
+    // promise it returned instead of emitting a response event
+    struct Reply {
+        explicit Reply(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)), settled(false) {}
+        Napi::Promise::Deferred deferred;
+        bool settled;  // JS thread only
+    };
+    using ReplyPtr = std::shared_ptr<Reply>;  // null in event mode
+    ReplyPtr NewReply(Napi::Env env);
+    Napi::Value ReplyValue(Napi::Env env, const ReplyPtr& reply);
+    Napi::Value Fail(Napi::Env env, const ReplyPtr& reply, const std::string& reason);
+    static bool Settle(const ReplyPtr& reply, Napi::Env env, Napi::Object eventObj);
+    // Resolves with a result that is not an event object (format 'json'); false in event mode
+    static bool Resolve(const ReplyPtr& reply, Napi::Value result);
+
+    // Format 'json': data events are serialized on the I/O thread and delivered as their JSON text.
+    // Starts the event object with clientID, type and, if given, event.
+    static void BeginJsonEvent(JsonWriter& json, const std::string& clientID, const char* event);
+
+    // Per-call options of request methods: { timeout: ms, signal: AbortSignal }
+    struct CallOptions {
+        uint32_t timeoutMs = 0;  // 0: the connection's request timeout
+        std::shared_ptr<std::atomic<bool>> aborted;  // set by the signal's abort listener
+        bool Aborted() const { return aborted && aborted->load(); }
+    };
+    CallOptions ParseCallOptions(Napi::Env env, Napi::Value value);
+    static Napi::Value AbortError(Napi::Env env);
+    void RejectAborted(Napi::Promise::Deferred deferred);
+    void EmitAborted(ReplyPtr reply, const std::string& method);
+
+    // Applies a per-call timeout to the requests sent while it is alive (I/O thread)
+    class RequestTimeoutScope {
+    public:
+        RequestTimeoutScope(IedConnection connection, uint32_t timeoutMs, uint32_t defaultMs);
+        ~RequestTimeoutScope();
+    private:
+        IedConnection connection_;
+        uint32_t defaultMs_;
+        bool active_;
+    };
+
+    // Read completion shared by the blocking and the pipelined path (I/O thread)
+    void CompleteRead(const std::string& dataRef, MmsValue* value, IedClientError error, Napi::Promise::Deferred deferred);
+    void CompleteDataSetRead(const std::string& datasetRef, ClientDataSet dataSet, IedClientError error, ReplyPtr reply);
+
+    // Reference -> FC cache of this connection, owned by the I/O thread
+    std::vector<FunctionalConstraint> ResolveFcOrder(const std::string& dataRef);
+    void RememberFc(const std::string& dataRef, FunctionalConstraint fc);
+    void ForgetFc(const std::string& dataRef);
+    void RememberMemberFc(const std::string& memberRef);
+
+    // Component names of references and data set members for namedFields, from their variable
+    // specifications and cached per connection like the FCs. I/O thread only.
+    std::shared_ptr<const FieldNames> FieldNamesFor(const std::string& dataRef, FunctionalConstraint fc);
+    std::shared_ptr<const FieldNames> FieldNamesFor(const std::string& dataRef);  // with the cached FC
+    std::shared_ptr<const FieldNames> MemberFieldNames(const std::string& memberRef);
+    std::vector<std::shared_ptr<const FieldNames>> DataSetFieldNames(const std::string& datasetRef);
+    void ClearModelCaches();
+
+    // readMany(): references packed into multi-variable reads per logical device
+    struct ReadManyItem {
+        std::string dataRef;
+        std::vector<FunctionalConstraint> fcs;  // empty: resolved from the FC cache on the I/O thread
+    };
+    void ReadManyChunk(MmsConnection mms, const std::string& domainId, const std::vector<std::string>& itemIds,
+                       const std::vector<size_t>& chunk, std::vector<MmsValue*>& values);
+
+    // Pipelined request mode: outstanding *Async calls, bounded by pipelineWindow_
+    struct PendingRead {
+        MmsClient* client;
+        std::string dataRef;
+        std::vector<FunctionalConstraint> fcs;
+        size_t fcIndex;
+        Napi::Promise::Deferred deferred;
+        CallOptions options;
+    };
+    struct PendingDataSetRead {
+        MmsClient* client;
+        std::string datasetRef;
+        ReplyPtr reply;
+    };
+    void SubmitPipelined(CommandQueue::Command send);
+    void CompletePipelined();
+    void RetryPipelined(CommandQueue::Command send);
+    void PumpPipelined();
+    void ApplyNegotiatedWindow();
+    void SendPipelinedRead(PendingRead* read);
+    static void ReadObjectHandler(uint32_t invokeId, void* parameter, IedClientError err, MmsValue* value);
+    static void ReadDataSetHandler(uint32_t invokeId, void* parameter, IedClientError err, ClientDataSet dataSet);
+
+    // Connection actor: the I/O thread owns connection_ and runs every queued command
+    void IoLoop();
+    void DrainCommands();
+    void StopIoThread();
+    void Post(CommandQueue::Command command);
+    void Post(CommandQueue::Lane lane, CommandQueue::Command command);
+    // Runs command on the actor once delay has passed, without holding it in the meantime
+    void Defer(std::chrono::steady_clock::duration delay, CommandQueue::Command command);
+    std::chrono::steady_clock::time_point PostDueCommands(std::chrono::steady_clock::time_point now);
+    static constexpr std::chrono::milliseconds CONTROL_TERMINATION_WAIT{1000};
+    void SendControlStatus(ReplyPtr reply, const std::string& stValRef, bool success);
+
+    // Reconnect state machine shared by the I/O thread and the threadless loop
+    void OnConnected();
+    void OnConnectFailed(IedClientError error);
+
+    // Threadless mode: connection_ is non-threaded and driven by the shared ConnectionLoop
+    bool OnTick(std::chrono::steady_clock::time_point now) override;
+    std::chrono::steady_clock::time_point NextTick(std::chrono::steady_clock::time_point now) override;
+    bool RunCommand() override;
+    bool HasCommands() override;
+    void ProbePrimary();
+
+    // Node loop mode: the non-threaded connection is ticked by a uv timer on the JS thread and
+    // events raised during the tick are delivered without going through the TSFN
+    using EmitCallback = std::function<void(Napi::Env, Napi::Function)>;
+    void Emit(EmitCallback callback);
+    // Unsolicited data events (reports) go through events_ when the eventQueue option bounds them;
+    // responses to requests always use Emit, so no promise is left unsettled by a drop
+    void EmitData(const std::string& key, EmitCallback callback);
+    void DrainEvents(Napi::Env env, Napi::Function jsCallback);
+    void StartNodeLoop(Napi::Env env);
+    void StopNodeLoop();
+    static void KickNodeLoop();
+    static void NodeLoopTick(uv_timer_t* handle);
+    std::chrono::steady_clock::time_point NodeLoopRound(std::chrono::steady_clock::time_point now);
+    void DeliverNodeLoopEvents();
    
-    // Struct for holding MMS value data
-    struct ResultData {
-        MmsType type;
-        float floatValue;
-        int32_t intValue;
-        bool boolValue;
-        std::string stringValue;
-        std::vector<ResultData> structureElements;
-        std::vector<ResultData> arrayElements;
-        bool isValid;
-        std::string errorReason;
+    // Native snapshot of the browsed model, filled on the I/O thread and converted on the JS thread
+    struct DataSetInfo {
+        std::string name;
+        std::string reference;
+        bool isDeletable;
+        std::vector<std::string> members;
+    };
+    struct LogicalNodeInfo {
+        std::string name;
+        std::vector<DataSetInfo> dataSets;
+    };
+    struct LogicalDeviceInfo {
+        std::string name;
+        std::vector<LogicalNodeInfo> logicalNodes;
+    };
+
+    // Everything the report handler needs, compiled once in enableReporting: the handler gets the
+    // plan as its parameter, so a report is decoded without looking the RCB up, walking the data set
+    // directory or building strings. Owned by its ReportInfo and kept until the handler is uninstalled.
+    //
+    // The handler runs on the libiec61850 receive (or ticker) thread while enable/disable run on the
+    // I/O thread, so it only reads the plan, which is immutable once installed, and never
+    // activeReports_ or mutable client state. Uninstalling the handler waits for a running callback
+    // (libiec61850 holds its report handler lock around it), and events still on their way to JS
+    // keep the plan alive through shared_from_this().
+    struct ReportPlan : std::enable_shared_from_this<ReportPlan> {
+        MmsClient* client;    // for delivery only
+        std::string clientID; // for the log lines and JSON events of this handler
+        ValueFormat format;
+        ConvertOptions convert;
+        bool sparse;
+        ReportJournal* journal;  // buffered RCBs with journalPath only
+        std::string rcbRef;
+        std::string rptId;
+        size_t dataSetSize;
+        std::vector<std::string> memberRefs;
+        std::vector<DecodePlan> members;  // objects format only; empty plans fall back to Append
+        std::vector<std::shared_ptr<const FieldNames>> memberNames;  // namedFields only
     };
+    // Buffered RCBs resume after the EntryID in journal_ (constructor option journalPath) instead
+    // of starting over with a GI. I/O thread.
+    bool ResumeBufferedReport(const std::string& rcbRef, ClientReportControlBlock rcb);
+    // Enables the reports of activeReports_ again after a reconnect
+    void RearmReports();
+    std::shared_ptr<ReportPlan> CompileReportPlan(const std::string& rcbRef, ClientReportControlBlock rcb,
+                                                  LinkedList dataSetDirectory, ClientDataSet dataSet);
+    void StartReporting(ReplyPtr reply, const std::string& rcbRef, const std::string& datasetRef,
+                        const std::function<void()>& onFailure = nullptr);
+
+    // reserveReport(): the RCB values of every candidate instance are requested at once through
+    // the pipeline window; the first free instance is reserved once all of them have answered
+    struct ReportReservation {
+        ReplyPtr reply;
+        std::string datasetRef;
+        std::vector<std::string> rcbRefs;
+        std::vector<ClientReportControlBlock> rcbs;  // nullptr: not readable
+        size_t pending;
+        size_t unreadable = 0;  // reads that failed for another reason than a missing instance
+    };
+    struct PendingRcbRead {
+        MmsClient* client;
+        std::shared_ptr<ReportReservation> reservation;
+        size_t index;
+    };
+    void SendRcbRead(PendingRcbRead* read);
+    static void GetRCBValuesHandler(uint32_t invokeId, void* parameter, IedClientError err, ClientReportControlBlock rcb);
+    void CompleteReservation(const std::shared_ptr<ReportReservation>& reservation);
+    static constexpr int16_t RESERVATION_TIME = 60;  // seconds, BRCB.ResvTms written by reserveReport()
+    bool ReserveRcb(const std::string& rcbRef, ClientReportControlBlock rcb);
+    void ReleaseRcb(const std::string& rcbRef, ClientReportControlBlock rcb);
 
     struct ReportInfo {
         ClientReportControlBlock rcb;
         ClientDataSet dataSet;
         LinkedList dataSetDirectory;
         std::string rcbRef;
+        std::shared_ptr<ReportPlan> plan;
     };
     std::map<std::string, ReportInfo> activeReports_;
 
     IedConnection connection_;
-    std::thread thread_;
-    std::mutex connMutex_;
+    std::thread ioThread_;
+    CommandQueue commands_;
+    bool pipeline_;
+    int requestedWindow_;  // maxOutstanding option
+    int windowLimit_;      // requestedWindow_ capped below the server's maxServOutstandingCalling
+    int pipelineWindow_;   // windowLimit_, or less while the server refuses calls
+    std::atomic<int> inFlight_;  // also read by the ticker in NextTick()
+    std::deque<CommandQueue::Command> pipelineBacklog_;
+    std::unordered_map<std::string, FunctionalConstraint> fcCache_;
+    std::unordered_map<std::string, std::shared_ptr<const FieldNames>> fieldNamesCache_;  // "ref[FC]"
+    std::unordered_map<std::string, std::vector<std::shared_ptr<const FieldNames>>> dataSetNamesCache_;
     Napi::ThreadSafeFunction tsfn_;
-    bool running_;
-    bool connected_;
+    std::atomic<bool> running_;
+    std::atomic<bool> connected_;
     std::string clientID_;
-    bool usingPrimaryIp_;
+    std::atomic<bool> usingPrimaryIp_;
+
+    std::string ip_;
+    std::string ipReserve_;
+    int port_;
+    int reconnectDelay_;
+    std::string currentIp_;
+    bool isPrimary_;
+    int primaryRetryCount_;
+    int reserveRetryCount_;
+    std::chrono::steady_clock::time_point nextPrimaryProbe_;
+
+    bool threadless_;
+    std::atomic<bool> connecting_;
+    std::atomic<bool> probing_;
+    std::chrono::steady_clock::time_point nextAttempt_;
+
+    bool nodeLoop_;
+    bool inNodeTick_;
+    std::unique_ptr<Napi::AsyncContext> asyncContext_;
+    Napi::FunctionReference emit_;
+    std::thread::id jsThread_;
+    std::vector<EmitCallback> nodeLoopEvents_;
+    std::mutex deferredMutex_;
+    std::multimap<std::chrono::steady_clock::time_point, CommandQueue::Command> deferred_;
+    std::unique_ptr<ReportJournal> journal_;
+    EventQueueOptions eventQueue_;
+    std::unique_ptr<EventQueue<EmitCallback>> events_;
+
+    // clientID_ as a JS string, shared by all events (JS thread only)
+    Napi::Reference<Napi::String> clientIdValue_;
+    Napi::String ClientIdValue(Napi::Env env) const { return clientIdValue_.Value(); }
+
+    bool promiseOnly_;
+    ValueFormat format_;       // member values of dataset reads and reports
+    ConvertOptions convert_;
+    bool namedFields_;         // structure keys from the variable specifications
+    bool sparseReports_;       // reports as entries of the included members only (objects format)
+    uint32_t requestTimeout_;  // connection default, restored after a per-call timeout
+
+    size_t batchMaxReports_;   // 0: every report is delivered on its own
+    std::chrono::milliseconds batchMaxLatency_;
+    std::mutex batchMutex_;
+    std::vector<ReportEvent> batch_;
+    std::vector<std::shared_ptr<ReportAck>> batchAcks_;  // journaled reports of the open batch
+    std::string batchJson_;
+    size_t batchJsonCount_;
+    std::chrono::steady_clock::time_point batchDeadline_;
+    std::atomic<bool> batchPending_;  // read without the mutex by the loops
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,758 @@
+#include "mms_value_converter.h"
+#include "event_keys.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <new>
+#include <iec61850_common.h>
+
+bool ConvertOptions::Parse(Napi::Env env, Napi::Object object, ConvertOptions& out) {
+    if (object.Has("timestampMode") && object.Get("timestampMode").IsString()) {
+        std::string mode = object.Get("timestampMode").As<Napi::String>().Utf8Value();
+        if (mode == "string") {
+            out.timestamps = TimestampMode::String;
+        } else if (mode == "ms") {
+            out.timestamps = TimestampMode::Milliseconds;
+        } else if (mode == "ns") {
+            out.timestamps = TimestampMode::Nanoseconds;
+        } else {
+            Napi::TypeError::New(env, "timestampMode must be 'string', 'ms' or 'ns'").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    if (object.Has("timeQuality") && object.Get("timeQuality").IsBoolean()) {
+        out.timeQuality = object.Get("timeQuality").As<Napi::Boolean>().Value();
+    }
+    if (object.Has("qualityMode") && object.Get("qualityMode").IsString()) {
+        std::string mode = object.Get("qualityMode").As<Napi::String>().Utf8Value();
+        if (mode == "string") {
+            out.quality = QualityMode::String;
+        } else if (mode == "bitmask") {
+            out.quality = QualityMode::Bitmask;
+        } else if (mode == "decoded") {
+            out.quality = QualityMode::Decoded;
+        } else {
+            Napi::TypeError::New(env, "qualityMode must be 'string', 'bitmask' or 'decoded'").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t FormatUtcTime(uint64_t ms, char* out, size_t size) {
+    time_t time = ms / 1000;
+    struct tm tmValue;
+#ifdef _WIN32
+    gmtime_s(&tmValue, &time);
+#else
+    gmtime_r(&time, &tmValue);
+#endif
+    size_t length = strftime(out, size, "%Y-%m-%d %H:%M:%S", &tmValue);
+    // Milliseconds are not zero padded, as before
+    int fraction = snprintf(out + length, size - length, ".%u", static_cast<unsigned>(ms % 1000));
+    return fraction > 0 ? length + fraction : length;
+}
+
+Napi::Value TimestampToNapi(Napi::Env env, uint64_t ns, TimestampMode mode) {
+    switch (mode) {
+        case TimestampMode::Milliseconds:
+            return Napi::Number::New(env, static_cast<double>(ns / 1000000));
+        case TimestampMode::Nanoseconds:
+            return Napi::BigInt::New(env, ns);
+        default: {
+            char text[64];
+            size_t length = FormatUtcTime(ns / 1000000, text, sizeof(text));
+            return Napi::String::New(env, text, length);
+        }
+    }
+}
+
+void TimestampToJson(JsonWriter& json, uint64_t ns, TimestampMode mode) {
+    if (mode == TimestampMode::String) {
+        char text[64];
+        json.String(text, FormatUtcTime(ns / 1000000, text, sizeof(text)));
+    } else if (mode == TimestampMode::Milliseconds) {
+        json.Uint(ns / 1000000);
+    } else {
+        json.Uint(ns);
+    }
+}
+
+static const char* const QUALITY_VALIDITIES[] = {"good", "reserved", "invalid", "questionable"};
+
+Napi::Object QualityToNapi(Napi::Env env, uint32_t bits) {
+    Napi::Object quality = Napi::Object::New(env);
+    quality.Set(EventKeys::Get(env, KEY_BITS), Napi::Number::New(env, bits));
+    quality.Set(EventKeys::Get(env, KEY_VALIDITY), Napi::String::New(env, QUALITY_VALIDITIES[bits & 3]));
+    quality.Set(EventKeys::Get(env, KEY_SOURCE), Napi::String::New(env, (bits & QUALITY_SOURCE_SUBSTITUTED) ? "substituted" : "process"));
+    quality.Set(EventKeys::Get(env, KEY_TEST), Napi::Boolean::New(env, (bits & QUALITY_TEST) != 0));
+    quality.Set(EventKeys::Get(env, KEY_OPERATOR_BLOCKED), Napi::Boolean::New(env, (bits & QUALITY_OPERATOR_BLOCKED) != 0));
+    return quality;
+}
+
+void QualityToJson(JsonWriter& json, uint32_t bits) {
+    json.BeginObject();
+    json.Key(EventKeys::Text(KEY_BITS));
+    json.Uint(bits);
+    json.Key(EventKeys::Text(KEY_VALIDITY));
+    json.String(QUALITY_VALIDITIES[bits & 3]);
+    json.Key(EventKeys::Text(KEY_SOURCE));
+    json.String((bits & QUALITY_SOURCE_SUBSTITUTED) ? "substituted" : "process");
+    json.Key(EventKeys::Text(KEY_TEST));
+    json.Bool((bits & QUALITY_TEST) != 0);
+    json.Key(EventKeys::Text(KEY_OPERATOR_BLOCKED));
+    json.Bool((bits & QUALITY_OPERATOR_BLOCKED) != 0);
+    json.EndObject();
+}
+
+uint64_t UtcTimeInNs(const MmsValue* val) {
+    uint32_t usec = 0;
+    uint64_t ms = MmsValue_getUtcTimeInMsWithUs(val, &usec);
+    return ms * 1000000ULL + usec * 1000ULL;
+}
+
+ValueHint FlatMmsValue::HintForAttribute(const std::string& attrName) {
+    if (attrName == "ctlModel") return ValueHint::CtlModel;
+    if (attrName == "q") return ValueHint::Quality;
+    return ValueHint::None;
+}
+
+std::shared_ptr<const FieldNames> FieldNames::FromSpecification(MmsVariableSpecification* spec) {
+    if (spec == nullptr) return nullptr;
+    MmsType type = MmsVariableSpecification_getType(spec);
+    if (type == MMS_STRUCTURE) {
+        auto fieldNames = std::make_shared<FieldNames>();
+        int size = MmsVariableSpecification_getSize(spec);
+        for (int i = 0; i < size; i++) {
+            MmsVariableSpecification* child = MmsVariableSpecification_getChildSpecificationByIndex(spec, i);
+            const char* name = child ? MmsVariableSpecification_getName(child) : nullptr;
+            fieldNames->names.push_back(name ? name : "");
+            fieldNames->children.push_back(FromSpecification(child));
+        }
+        return fieldNames;
+    }
+    if (type == MMS_ARRAY) {
+        auto element = FromSpecification(MmsVariableSpecification_getArrayElementSpecification(spec));
+        if (!element) return nullptr;
+        auto fieldNames = std::make_shared<FieldNames>();
+        fieldNames->isArray = true;
+        fieldNames->children.push_back(element);
+        return fieldNames;
+    }
+    return nullptr;
+}
+
+void FlatMmsValue::Append(MmsValue* val, ValueHint hint, const std::shared_ptr<const FieldNames>& names) {
+    roots_.push_back(static_cast<uint32_t>(nodes_.size()));
+    if (names) fieldNames_.push_back(names);
+    Flatten(val, hint, names.get());
+}
+
+void FlatMmsValue::AppendInvalid(const std::string& reason) {
+    roots_.push_back(static_cast<uint32_t>(nodes_.size()));
+    PushString(KIND_INVALID, reason);
+}
+
+void FlatMmsValue::PushString(Kind kind, const char* text, size_t length) {
+    Node node;
+    node.kind = kind;
+    node.name = 0;
+    node.count = static_cast<uint32_t>(length);
+    node.offset = static_cast<uint32_t>(arena_.size());
+    arena_.append(text, length);
+    nodes_.push_back(node);
+}
+
+void FlatMmsValue::Flatten(MmsValue* val, ValueHint hint, const FieldNames* names) {
+    Node node;
+    node.name = 0;
+    node.count = 0;
+    char text[64];
+
+    MmsType type = MmsValue_getType(val);
+    switch (type) {
+        case MMS_FLOAT: {
+            // Read as float, like the addon always did, also for 64 bit values
+            float value = MmsValue_toFloat(val);
+            if (std::isnan(value) || std::isinf(value)) {
+                PushString(KIND_INVALID, "Invalid float value");
+                return;
+            }
+            node.kind = KIND_NUMBER;
+            node.number = value;
+            nodes_.push_back(node);
+            return;
+        }
+        case MMS_INTEGER: {
+            int32_t value = MmsValue_toInt32(val);
+            if (hint == ValueHint::CtlModel) {
+                switch (value) {
+                    case 0: PushString(KIND_STRING, "status-only"); return;
+                    case 1: PushString(KIND_STRING, "direct-with-normal-security"); return;
+                    case 2: PushString(KIND_STRING, "sbo-with-normal-security"); return;
+                    case 3: PushString(KIND_STRING, "direct-with-enhanced-security"); return;
+                    case 4: PushString(KIND_STRING, "sbo-with-enhanced-security"); return;
+                    default: {
+                        int length = snprintf(text, sizeof(text), "unknown(%d)", value);
+                        PushString(KIND_STRING, text, length);
+                        return;
+                    }
+                }
+            }
+            node.kind = KIND_INTEGER;
+            node.integer = value;
+            nodes_.push_back(node);
+            return;
+        }
+        case MMS_BOOLEAN:
+            node.kind = KIND_BOOLEAN;
+            node.boolean = MmsValue_getBoolean(val);
+            nodes_.push_back(node);
+            return;
+        case MMS_VISIBLE_STRING: {
+            const char* str = MmsValue_toString(val);
+            PushString(KIND_STRING, str ? str : "", str ? strlen(str) : 0);
+            return;
+        }
+        case MMS_UTC_TIME: {
+            if (options_.timestamps == TimestampMode::String) {
+                size_t length = FormatUtcTime(MmsValue_getUtcTimeInMs(val), text, sizeof(text));
+                PushString(KIND_STRING, text, length);
+                return;
+            }
+            node.kind = KIND_TIME;
+            node.time = UtcTimeInNs(val);
+            node.count = MmsValue_getUtcTimeQuality(val);
+            nodes_.push_back(node);
+            return;
+        }
+        case MMS_BIT_STRING: {
+            if (options_.quality != QualityMode::String) {
+                node.kind = KIND_BITS;
+                node.bits = MmsValue_getBitStringAsInteger(val);
+                node.count = MmsValue_getBitStringSize(val);
+                nodes_.push_back(node);
+                return;
+            }
+            if (hint == ValueHint::Quality) {
+                uint32_t quality = MmsValue_getBitStringAsInteger(val);
+                bool invalid = quality & QUALITY_VALIDITY_INVALID;
+                bool questionable = quality & QUALITY_VALIDITY_QUESTIONABLE;
+                if (invalid && questionable) PushString(KIND_STRING, "Invalid|Questionable");
+                else if (invalid) PushString(KIND_STRING, "Invalid");
+                else if (questionable) PushString(KIND_STRING, "Questionable");
+                else PushString(KIND_STRING, "Good");
+                return;
+            }
+            int length = snprintf(text, sizeof(text), "BitString(size=%d)", MmsValue_getBitStringSize(val));
+            PushString(KIND_STRING, text, length);
+            return;
+        }
+        case MMS_STRUCTURE:
+        case MMS_ARRAY: {
+            size_t index = nodes_.size();
+            node.kind = (type == MMS_STRUCTURE) ? KIND_STRUCTURE : KIND_ARRAY;
+            node.offset = 0;
+            nodes_.push_back(node);
+            uint32_t size = MmsValue_getArraySize(val);
+            // Names only apply when the value matches the specification they came from
+            if (names && (names->isArray != (type == MMS_ARRAY) ||
+                          (!names->isArray && names->names.size() != size))) {
+                names = nullptr;
+            }
+            uint32_t kept = 0;
+            for (uint32_t i = 0; i < size; i++) {
+                MmsValue* element = MmsValue_getElement(val, i);
+                if (!element) continue;
+                size_t child = nodes_.size();
+                size_t namesBefore = names_.size();
+                if (type == MMS_ARRAY) {
+                    // Array elements inherit the attribute name
+                    const FieldNames* elementNames = nullptr;
+                    if (names && names->children.size() == 1) {
+                        elementNames = names->children[0].get();
+                    } else if (names && i < names->children.size()) {
+                        elementNames = names->children[i].get();
+                    }
+                    Flatten(element, hint, elementNames);
+                } else if (names && names_.size() <= UINT16_MAX) {
+                    // Named components get the renderings of their own name (q, ctlModel)
+                    const std::string& name = names->names[i];
+                    Flatten(element, HintForAttribute(name), names->children[i].get());
+                    nodes_[child].name = static_cast<uint16_t>(names_.size());
+                    names_.push_back(&name);
+                } else {
+                    Flatten(element, ValueHint::None, nullptr);
+                }
+                if (type == MMS_STRUCTURE && nodes_[child].kind == KIND_INVALID) {
+                    // Invalid members are left out of structures; the error is the newest string
+                    arena_.resize(nodes_[child].offset);
+                    nodes_.resize(child);
+                    names_.resize(namesBefore);
+                    continue;
+                }
+                kept++;
+            }
+            nodes_[index].count = kept;
+            return;
+        }
+        case MMS_DATA_ACCESS_ERROR:
+            PushString(KIND_INVALID, "Data access error");
+            return;
+        default: {
+            int length = snprintf(text, sizeof(text), "Unsupported type: %d", type);
+            PushString(KIND_INVALID, text, length);
+            return;
+        }
+    }
+}
+
+DecodePlan DecodePlan::Compile(MmsValue* sample, ValueHint hint, const std::shared_ptr<const FieldNames>& names) {
+    DecodePlan plan;
+    plan.names_ = names;
+    if (!sample || !plan.Add(sample, hint, names.get(), nullptr, 0) || plan.nameCount_ > UINT16_MAX) {
+        plan.steps_.clear();
+    }
+    return plan;
+}
+
+// Mirrors FlatMmsValue::Flatten, but records the walk instead of converting values
+bool DecodePlan::Add(MmsValue* val, ValueHint hint, const FieldNames* names, const std::string* name, int depth) {
+    if (depth >= MAX_DEPTH) return false;
+    MmsType type = MmsValue_getType(val);
+    if (name) nameCount_++;
+    if (type != MMS_STRUCTURE && type != MMS_ARRAY) {
+        steps_.push_back({type, hint, 0, name});
+        return true;
+    }
+    uint32_t size = MmsValue_getArraySize(val);
+    if (names && (names->isArray != (type == MMS_ARRAY) ||
+                  (!names->isArray && names->names.size() != size))) {
+        names = nullptr;
+    }
+    steps_.push_back({type, hint, size, name});
+    for (uint32_t i = 0; i < size; i++) {
+        MmsValue* element = MmsValue_getElement(val, i);
+        if (!element) return false;
+        bool planned;
+        if (type == MMS_ARRAY) {
+            const FieldNames* elementNames = nullptr;
+            if (names && names->children.size() == 1) {
+                elementNames = names->children[0].get();
+            } else if (names && i < names->children.size()) {
+                elementNames = names->children[i].get();
+            }
+            planned = Add(element, hint, elementNames, nullptr, depth + 1);
+        } else if (names) {
+            const std::string& component = names->names[i];
+            planned = Add(element, FlatMmsValue::HintForAttribute(component), names->children[i].get(), &component, depth + 1);
+        } else {
+            planned = Add(element, ValueHint::None, nullptr, nullptr, depth + 1);
+        }
+        if (!planned) return false;
+    }
+    return true;
+}
+
+bool FlatMmsValue::AppendPlanned(MmsValue* val, const DecodePlan& plan) {
+    if (plan.Empty() || names_.size() + plan.nameCount_ > UINT16_MAX) return false;
+
+    struct Frame {
+        MmsValue* container;
+        uint32_t next;
+        uint32_t size;
+        uint32_t node;
+        uint32_t kept;
+        bool structure;
+    };
+    Frame stack[DecodePlan::MAX_DEPTH];
+    int depth = 0;
+    size_t nodesBefore = nodes_.size();
+    size_t namesBefore = names_.size();
+    size_t arenaBefore = arena_.size();
+
+    for (const DecodePlan::Step& step : plan.steps_) {
+        MmsValue* element = val;
+        if (depth > 0) {
+            Frame& parent = stack[depth - 1];
+            element = MmsValue_getElement(parent.container, parent.next++);
+        }
+        if (!element || MmsValue_getType(element) != step.type ||
+            ((step.type == MMS_STRUCTURE || step.type == MMS_ARRAY) && MmsValue_getArraySize(element) != step.size)) {
+            nodes_.resize(nodesBefore);
+            names_.resize(namesBefore);
+            arena_.resize(arenaBefore);
+            return false;
+        }
+
+        size_t child = nodes_.size();
+        bool kept = true;
+        if (step.type == MMS_STRUCTURE || step.type == MMS_ARRAY) {
+            Node node;
+            node.kind = (step.type == MMS_STRUCTURE) ? KIND_STRUCTURE : KIND_ARRAY;
+            node.name = 0;
+            node.count = 0;
+            node.offset = 0;
+            nodes_.push_back(node);
+            if (step.name) {
+                nodes_[child].name = static_cast<uint16_t>(names_.size());
+                names_.push_back(step.name);
+            }
+            if (step.size > 0) {
+                stack[depth++] = {element, 0, step.size, static_cast<uint32_t>(child), 0, step.type == MMS_STRUCTURE};
+                continue;
+            }
+        } else {
+            Flatten(element, step.hint, nullptr);
+            if (depth > 0 && stack[depth - 1].structure && nodes_[child].kind == KIND_INVALID) {
+                // Invalid members are left out of structures; the error is the newest string
+                arena_.resize(nodes_[child].offset);
+                nodes_.resize(child);
+                kept = false;
+            } else if (step.name) {
+                nodes_[child].name = static_cast<uint16_t>(names_.size());
+                names_.push_back(step.name);
+            }
+        }
+
+        // The node is complete: count it and close the containers it completed
+        if (depth > 0 && kept) stack[depth - 1].kept++;
+        while (depth > 0 && stack[depth - 1].next == stack[depth - 1].size) {
+            Frame& done = stack[--depth];
+            nodes_[done.node].count = done.kept;
+            if (depth > 0) stack[depth - 1].kept++;
+        }
+    }
+
+    roots_.push_back(static_cast<uint32_t>(nodesBefore));
+    if (plan.names_) fieldNames_.push_back(plan.names_);
+    return true;
+}
+
+Napi::Value FlatMmsValue::ToNapi(Napi::Env env, size_t root) const {
+    size_t index = roots_[root];
+    return Materialize(env, index);
+}
+
+Napi::Value FlatMmsValue::Materialize(Napi::Env env, size_t& index) const {
+    const Node& node = nodes_[index++];
+    switch (node.kind) {
+        case KIND_NUMBER:
+            return Napi::Number::New(env, node.number);
+        case KIND_INTEGER:
+            return Napi::Number::New(env, node.integer);
+        case KIND_BOOLEAN:
+            return Napi::Boolean::New(env, node.boolean);
+        case KIND_STRING:
+        case KIND_INVALID:
+            return Napi::String::New(env, arena_.data() + node.offset, node.count);
+        case KIND_TIME: {
+            Napi::Value time = TimestampToNapi(env, node.time, options_.timestamps);
+            if (!options_.timeQuality) return time;
+            Napi::Object timeObj = Napi::Object::New(env);
+            timeObj.Set(EventKeys::Get(env, KEY_TIME), time);
+            timeObj.Set(EventKeys::Get(env, KEY_QUALITY), Napi::Number::New(env, node.count));
+            return timeObj;
+        }
+        case KIND_BITS:
+            if (options_.quality == QualityMode::Decoded && node.count == 13) {
+                return QualityToNapi(env, node.bits);
+            }
+            return Napi::Number::New(env, node.bits);
+        case KIND_STRUCTURE: {
+            Napi::Object structObj = Napi::Object::New(env);
+            for (uint32_t i = 0; i < node.count; i++) {
+                uint16_t name = nodes_[index].name;
+                Napi::String key = name ? EventKeys::Name(env, *names_[name]) : EventKeys::Field(env, i);
+                structObj.Set(key, Materialize(env, index));
+            }
+            return structObj;
+        }
+        case KIND_ARRAY: {
+            Napi::Array array = Napi::Array::New(env, node.count);
+            for (uint32_t i = 0; i < node.count; i++) {
+                array.Set(i, Materialize(env, index));
+            }
+            return array;
+        }
+    }
+    return env.Undefined();
+}
+
+void FlatMmsValue::WriteJson(JsonWriter& json, size_t root) const {
+    size_t index = roots_[root];
+    Serialize(json, index);
+}
+
+// Materialize, writing JSON text instead of creating JS values
+void FlatMmsValue::Serialize(JsonWriter& json, size_t& index) const {
+    const Node& node = nodes_[index++];
+    switch (node.kind) {
+        case KIND_NUMBER:
+            json.Double(node.number);
+            return;
+        case KIND_INTEGER:
+            json.Int(node.integer);
+            return;
+        case KIND_BOOLEAN:
+            json.Bool(node.boolean);
+            return;
+        case KIND_STRING:
+        case KIND_INVALID:
+            json.String(arena_.data() + node.offset, node.count);
+            return;
+        case KIND_TIME:
+            if (!options_.timeQuality) {
+                TimestampToJson(json, node.time, options_.timestamps);
+                return;
+            }
+            json.BeginObject();
+            json.Key(EventKeys::Text(KEY_TIME));
+            TimestampToJson(json, node.time, options_.timestamps);
+            json.Key(EventKeys::Text(KEY_QUALITY));
+            json.Uint(node.count);
+            json.EndObject();
+            return;
+        case KIND_BITS:
+            if (options_.quality == QualityMode::Decoded && node.count == 13) {
+                QualityToJson(json, node.bits);
+                return;
+            }
+            json.Uint(node.bits);
+            return;
+        case KIND_STRUCTURE: {
+            json.BeginObject();
+            char field[24];
+            for (uint32_t i = 0; i < node.count; i++) {
+                uint16_t name = nodes_[index].name;
+                if (name) {
+                    json.Key(*names_[name]);
+                } else {
+                    json.Key(field, snprintf(field, sizeof(field), "field%u", i));
+                }
+                Serialize(json, index);
+            }
+            json.EndObject();
+            return;
+        }
+        case KIND_ARRAY:
+            json.BeginArray();
+            for (uint32_t i = 0; i < node.count; i++) {
+                Serialize(json, index);
+            }
+            json.EndArray();
+            return;
+    }
+}
+
+ColumnarMmsValues::ColumnarMmsValues(size_t count, TimestampMode timestamps)
+    : count_(count), timestampMode_(timestamps), buffer_(nullptr) {
+    if (count_ > 0) {
+        buffer_ = static_cast<uint8_t*>(malloc(count_ * ROW_SIZE));
+        if (buffer_ == nullptr) throw std::bad_alloc();
+    }
+    // Widest columns first keeps every column naturally aligned
+    values_ = reinterpret_cast<double*>(buffer_);
+    timestamps_ = reinterpret_cast<uint64_t*>(buffer_ + count_ * sizeof(double));
+    quality_ = reinterpret_cast<uint32_t*>(buffer_ + count_ * (sizeof(double) + sizeof(uint64_t)));
+    types_ = buffer_ + count_ * (sizeof(double) + sizeof(uint64_t) + sizeof(uint32_t));
+    reasons_ = types_ + count_;
+    for (size_t i = 0; i < count_; i++) {
+        values_[i] = std::numeric_limits<double>::quiet_NaN();
+        timestamps_[i] = 0;
+        quality_[i] = 0;
+        types_[i] = TYPE_NOT_INCLUDED;
+        reasons_[i] = 0;
+    }
+}
+
+ColumnarMmsValues::~ColumnarMmsValues() {
+    free(buffer_);
+}
+
+void ColumnarMmsValues::Set(size_t index, MmsValue* member) {
+    types_[index] = static_cast<uint8_t>(MmsValue_getType(member));
+    bool haveValue = false, haveQuality = false, haveTime = false;
+    Scan(member, index, haveValue, haveQuality, haveTime);
+}
+
+void ColumnarMmsValues::Scan(MmsValue* val, size_t index, bool& haveValue, bool& haveQuality, bool& haveTime) {
+    MmsType type = MmsValue_getType(val);
+    switch (type) {
+        case MMS_FLOAT:
+        case MMS_INTEGER:
+        case MMS_UNSIGNED:
+        case MMS_BOOLEAN:
+            if (haveValue) return;
+            if (type == MMS_FLOAT) values_[index] = MmsValue_toDouble(val);
+            else if (type == MMS_INTEGER) values_[index] = static_cast<double>(MmsValue_toInt64(val));
+            else if (type == MMS_UNSIGNED) values_[index] = MmsValue_toUint32(val);
+            else values_[index] = MmsValue_getBoolean(val) ? 1.0 : 0.0;
+            types_[index] = static_cast<uint8_t>(type);
+            haveValue = true;
+            return;
+        case MMS_BIT_STRING:
+            // 13 bits is the size of the IEC 61850 quality, anything else is a value like Dbpos
+            if (MmsValue_getBitStringSize(val) == 13) {
+                if (haveQuality) return;
+                quality_[index] = MmsValue_getBitStringAsInteger(val);
+                haveQuality = true;
+            } else if (!haveValue) {
+                values_[index] = MmsValue_getBitStringAsInteger(val);
+                types_[index] = static_cast<uint8_t>(type);
+                haveValue = true;
+            }
+            return;
+        case MMS_UTC_TIME:
+            if (haveTime) return;
+            timestamps_[index] = (timestampMode_ == TimestampMode::Nanoseconds) ? UtcTimeInNs(val)
+                                                                                : MmsValue_getUtcTimeInMs(val);
+            haveTime = true;
+            return;
+        case MMS_STRUCTURE:
+        case MMS_ARRAY: {
+            uint32_t size = MmsValue_getArraySize(val);
+            for (uint32_t i = 0; i < size && !(haveValue && haveQuality && haveTime); i++) {
+                MmsValue* element = MmsValue_getElement(val, i);
+                if (element) Scan(element, index, haveValue, haveQuality, haveTime);
+            }
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+Napi::Object ColumnarMmsValues::ToNapi(Napi::Env env, bool withReasons) {
+    Napi::ArrayBuffer arrayBuffer;
+    if (buffer_ != nullptr) {
+        arrayBuffer = Napi::ArrayBuffer::New(env, buffer_, count_ * ROW_SIZE,
+                                             [](Napi::Env, void* data) { free(data); });
+        buffer_ = nullptr;
+    } else {
+        arrayBuffer = Napi::ArrayBuffer::New(env, 0);
+    }
+
+    size_t offset = 0;
+    Napi::Object columns = Napi::Object::New(env);
+    columns.Set(EventKeys::Get(env, KEY_VALUES), Napi::Float64Array::New(env, count_, arrayBuffer, offset, napi_float64_array));
+    offset += count_ * sizeof(double);
+    columns.Set("timestamps", Napi::BigUint64Array::New(env, count_, arrayBuffer, offset, napi_biguint64_array));
+    offset += count_ * sizeof(uint64_t);
+    columns.Set(EventKeys::Get(env, KEY_QUALITY), Napi::Uint32Array::New(env, count_, arrayBuffer, offset, napi_uint32_array));
+    offset += count_ * sizeof(uint32_t);
+    columns.Set("types", Napi::Uint8Array::New(env, count_, arrayBuffer, offset, napi_uint8_array));
+    offset += count_;
+    if (withReasons) {
+        columns.Set("reasons", Napi::Uint8Array::New(env, count_, arrayBuffer, offset, napi_uint8_array));
+    }
+    return columns;
+}
+
+BinaryMmsValues::BinaryMmsValues(size_t count, bool withReasons) : count_(count), next_(0) {
+    size_t header = 2 * sizeof(uint32_t) + (count_ + 1) * sizeof(uint32_t);
+    reasonsOffset_ = header;
+    if (withReasons) header += count_;
+    buffer_.reserve(header + count_ * 16);
+    buffer_.resize(header, 0);
+    PutAt<uint32_t>(0, static_cast<uint32_t>(count_));
+    PutAt<uint32_t>(sizeof(uint32_t), withReasons ? FLAG_REASONS : 0);
+}
+
+// All supported targets are little-endian, so values are stored in host order
+template <typename T>
+void BinaryMmsValues::Put(T value) {
+    size_t position = buffer_.size();
+    buffer_.resize(position + sizeof(T));
+    memcpy(buffer_.data() + position, &value, sizeof(T));
+}
+
+template <typename T>
+void BinaryMmsValues::PutAt(size_t position, T value) {
+    memcpy(buffer_.data() + position, &value, sizeof(T));
+}
+
+void BinaryMmsValues::CloseMembers(size_t upTo) {
+    for (; next_ <= upTo && next_ <= count_; next_++) {
+        PutAt<uint32_t>(2 * sizeof(uint32_t) + next_ * sizeof(uint32_t), static_cast<uint32_t>(buffer_.size()));
+    }
+}
+
+void BinaryMmsValues::Set(size_t index, MmsValue* member) {
+    if (index < next_ || index >= count_) return;
+    CloseMembers(index);
+    Encode(member);
+}
+
+void BinaryMmsValues::SetReason(size_t index, uint8_t reason) {
+    buffer_[reasonsOffset_ + index] = reason;
+}
+
+void BinaryMmsValues::Encode(MmsValue* val) {
+    MmsType type = MmsValue_getType(val);
+    switch (type) {
+        case MMS_STRUCTURE:
+        case MMS_ARRAY: {
+            Put<uint8_t>(type);
+            size_t countPosition = buffer_.size();
+            Put<uint32_t>(0);
+            uint32_t size = MmsValue_getArraySize(val);
+            uint32_t encoded = 0;
+            for (uint32_t i = 0; i < size; i++) {
+                MmsValue* element = MmsValue_getElement(val, i);
+                if (!element) continue;
+                Encode(element);
+                encoded++;
+            }
+            PutAt<uint32_t>(countPosition, encoded);
+            return;
+        }
+        case MMS_BOOLEAN:
+            Put<uint8_t>(type);
+            Put<uint8_t>(MmsValue_getBoolean(val) ? 1 : 0);
+            return;
+        case MMS_BIT_STRING:
+            Put<uint8_t>(type);
+            Put<uint16_t>(static_cast<uint16_t>(MmsValue_getBitStringSize(val)));
+            Put<uint32_t>(MmsValue_getBitStringAsInteger(val));
+            return;
+        case MMS_INTEGER:
+            Put<uint8_t>(type);
+            Put<int32_t>(MmsValue_toInt32(val));
+            return;
+        case MMS_FLOAT:
+            Put<uint8_t>(type);
+            Put<float>(MmsValue_toFloat(val));
+            return;
+        case MMS_VISIBLE_STRING: {
+            const char* str = MmsValue_toString(val);
+            uint32_t length = str ? static_cast<uint32_t>(strlen(str)) : 0;
+            Put<uint8_t>(type);
+            Put<uint32_t>(length);
+            buffer_.insert(buffer_.end(), str, str + length);
+            return;
+        }
+        case MMS_UTC_TIME:
+            Put<uint8_t>(type);
+            Put<uint64_t>(UtcTimeInNs(val));
+            Put<uint8_t>(MmsValue_getUtcTimeQuality(val));
+            return;
+        case MMS_DATA_ACCESS_ERROR:
+            Put<uint8_t>(type);
+            return;
+        default:
+            Put<uint8_t>(TAG_UNSUPPORTED);
+            Put<uint8_t>(type);
+            return;
+    }
+}
+
+Napi::ArrayBuffer BinaryMmsValues::ToNapi(Napi::Env env) {
+    CloseMembers(count_);
+    auto* bytes = new std::vector<uint8_t>(std::move(buffer_));
+    return Napi::ArrayBuffer::New(env, bytes->data(), bytes->size(),
+                                  [](Napi::Env, void*, std::vector<uint8_t>* hint) { delete hint; }, bytes);
+}
@@ -0,0 +1,260 @@
+#ifndef MMS_VALUE_CONVERTER_H
+#define MMS_VALUE_CONVERTER_H
+
+#include <napi.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mms_value.h>
+#include <mms_type_spec.h>
+#include "json_writer.h"
+
+// readData() renders a few attributes by name; the hint carries that name down the value tree
+enum class ValueHint : uint8_t {
+    None,
+    CtlModel,  // INTEGER rendered as the control model name
+    Quality    // BIT STRING rendered as "Good" / "Invalid|Questionable"
+};
+
+// How MMS UTC times are handed to JS
+enum class TimestampMode : uint8_t {
+    String,        // "YYYY-MM-DD hh:mm:ss.ms", the historical rendering
+    Milliseconds,  // Number, ms since the epoch
+    Nanoseconds    // BigInt, ns since the epoch
+};
+
+// How MMS bit strings (quality, Dbpos, ...) are handed to JS
+enum class QualityMode : uint8_t {
+    String,   // "BitString(size=N)", readData renders attributes named q as "Good" / "Invalid|..."
+    Bitmask,  // Number, bit 0 of the bit string is bit 0 of the number
+    Decoded   // like Bitmask, 13 bit qualities become { bits, validity, source, test, operatorBlocked }
+};
+
+// Value rendering options of a client, read once from its constructor options
+struct ConvertOptions {
+    TimestampMode timestamps = TimestampMode::String;
+    bool timeQuality = false;  // numeric timestamps become { time, quality } with the time quality byte
+    QualityMode quality = QualityMode::String;
+
+    // Reads timestampMode/timeQuality/qualityMode from a JS options object. Throws a TypeError
+    // into JS and returns false on invalid values.
+    static bool Parse(Napi::Env env, Napi::Object object, ConvertOptions& out);
+};
+
+// Formats ms since the epoch the way the addon always did, returns the length
+size_t FormatUtcTime(uint64_t ms, char* out, size_t size);
+// A timestamp (ns since the epoch) in the representation selected by mode
+Napi::Value TimestampToNapi(Napi::Env env, uint64_t ns, TimestampMode mode);
+// A 13 bit IEC 61850 quality as { bits, validity, source, test, operatorBlocked }
+Napi::Object QualityToNapi(Napi::Env env, uint32_t bits);
+void QualityToJson(JsonWriter& json, uint32_t bits);
+// TimestampToNapi for events serialized to JSON; 'ns' timestamps are written as integers
+void TimestampToJson(JsonWriter& json, uint64_t ns, TimestampMode mode);
+// ns since the epoch of an MMS_UTC_TIME value
+uint64_t UtcTimeInNs(const MmsValue* val);
+
+// How dataset reads and reports hand their member values to JS
+enum class ValueFormat : uint8_t {
+    Objects,  // one JS value per member, see FlatMmsValue
+    Columnar, // typed array columns, see ColumnarMmsValues
+    Binary,   // encoded payload decoded on demand in JS, see BinaryMmsValues
+    Json      // whole events serialized to JSON text natively, see FlatMmsValue::WriteJson
+};
+
+// Component names of a structured MMS type, taken once from its MmsVariableSpecification. Immutable
+// after construction, so one instance is shared by every value of that reference.
+struct FieldNames {
+    bool isArray = false;
+    std::vector<std::string> names;  // structure: one per component
+    // structure: one per component; array: the element type, or one per element for the
+    // heterogeneous values of a data set; null for primitive components
+    std::vector<std::shared_ptr<const FieldNames>> children;
+
+    // null if the type has no named components
+    static std::shared_ptr<const FieldNames> FromSpecification(MmsVariableSpecification* spec);
+};
+
+// Flat pre-order description of a value's type tree, compiled once from a sample value (the
+// members read when a report is enabled) so that later values of the same type are flattened in
+// one linear loop, without recursion or name lookups. Keeps the names it refers to alive.
+class DecodePlan {
+public:
+    // An empty plan if the sample cannot be planned; FlatMmsValue then falls back to Append
+    static DecodePlan Compile(MmsValue* sample, ValueHint hint, const std::shared_ptr<const FieldNames>& names);
+
+    bool Empty() const { return steps_.empty(); }
+
+private:
+    friend class FlatMmsValue;
+    static const int MAX_DEPTH = 16;
+
+    struct Step {
+        MmsType type;
+        ValueHint hint;
+        uint32_t size;            // components of a container
+        const std::string* name;  // component name, null for positional keys
+    };
+
+    bool Add(MmsValue* val, ValueHint hint, const FieldNames* names, const std::string* name, int depth);
+
+    std::vector<Step> steps_;
+    uint32_t nameCount_ = 0;
+    std::shared_ptr<const FieldNames> names_;
+};
+
+// Flattened copy of one or more MmsValue trees. Values are captured on the libiec61850 thread
+// into a node array (pre-order, containers store their child count) plus one string arena, and
+// later turned into JS values on the JS thread in a single walk. The JS shapes are the ones the
+// addon always produced: STRUCTURE -> { field0, field1, ... } without invalid members, ARRAY ->
+// array, invalid values -> their error text.
+class FlatMmsValue {
+public:
+    explicit FlatMmsValue(const ConvertOptions& options = ConvertOptions()) : options_(options) {}
+
+    static ValueHint HintForAttribute(const std::string& attrName);
+
+    // Appends val as a new root. val is only read during the call. With names, structures get
+    // their component names as keys instead of field0, field1, ...
+    void Append(MmsValue* val, ValueHint hint = ValueHint::None,
+                const std::shared_ptr<const FieldNames>& names = nullptr);
+    // Appends val like Append, following a plan compiled for its type. Returns false without
+    // appending anything if val does not have the planned type.
+    bool AppendPlanned(MmsValue* val, const DecodePlan& plan);
+    // Appends a root that materializes as the given error text
+    void AppendInvalid(const std::string& reason);
+
+    size_t RootCount() const { return roots_.size(); }
+    bool IsValid(size_t root) const { return nodes_[roots_[root]].kind != KIND_INVALID; }
+
+    // JS thread only
+    Napi::Value ToNapi(Napi::Env env, size_t root) const;
+    // The JSON text of the value ToNapi would return (any thread). 'ns' timestamps, BigInts in
+    // JS, are written as integers.
+    void WriteJson(JsonWriter& json, size_t root) const;
+
+private:
+    enum Kind : uint8_t {
+        KIND_NUMBER,
+        KIND_INTEGER,
+        KIND_BOOLEAN,
+        KIND_STRING,
+        KIND_INVALID,
+        KIND_TIME,
+        KIND_BITS,
+        KIND_STRUCTURE,
+        KIND_ARRAY
+    };
+
+    struct Node {
+        Kind kind;
+        uint16_t name;   // component name, index into names_; 0 for positional keys
+        uint32_t count;  // children of a container, length of a string, time quality, bit string size
+        union {
+            double number;
+            int32_t integer;
+            bool boolean;
+            uint32_t offset;  // into arena_
+            uint32_t bits;    // bit 0 of the bit string first
+            uint64_t time;    // ns since the epoch
+        };
+    };
+
+    void Flatten(MmsValue* val, ValueHint hint, const FieldNames* names);
+    void PushString(Kind kind, const char* text, size_t length);
+    void PushString(Kind kind, const std::string& text) { PushString(kind, text.data(), text.size()); }
+    Napi::Value Materialize(Napi::Env env, size_t& index) const;
+    void Serialize(JsonWriter& json, size_t& index) const;
+
+    ConvertOptions options_;
+    std::vector<std::shared_ptr<const FieldNames>> fieldNames_;  // keeps names_ alive
+    std::vector<const std::string*> names_{nullptr};
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> roots_;
+    std::string arena_;
+};
+
+// Dataset members as parallel columns: value (Float64Array), MMS type (Uint8Array), quality bits
+// (Uint32Array), timestamp in ms (BigUint64Array) and, for reports, the reason for inclusion
+// (Uint8Array). The columns are filled on the libiec61850 thread into one buffer that becomes
+// the external backing store of all typed arrays, so no JS value is created per member.
+//
+// A member that is a structure (an FCDA on data object level) is searched in order for its
+// first numeric or bit string leaf (value), its first 13 bit BIT STRING (quality) and its first
+// UTC time (timestamp, in ns with TimestampMode::Nanoseconds, in ms otherwise). Members without
+// a numeric value keep NaN and the type of the member.
+class ColumnarMmsValues {
+public:
+    static const uint8_t TYPE_NOT_INCLUDED = 0xFF;
+
+    ColumnarMmsValues(size_t count, TimestampMode timestamps);
+    ~ColumnarMmsValues();
+    ColumnarMmsValues(const ColumnarMmsValues&) = delete;
+    ColumnarMmsValues& operator=(const ColumnarMmsValues&) = delete;
+
+    size_t Count() const { return count_; }
+    // member is only read during the call
+    void Set(size_t index, MmsValue* member);
+    void SetReason(size_t index, uint8_t reason) { reasons_[index] = reason; }
+
+    // JS thread only. Hands the buffer over to the returned typed arrays, so call it once.
+    Napi::Object ToNapi(Napi::Env env, bool withReasons);
+
+private:
+    // values, timestamps, quality, types, reasons
+    static const size_t ROW_SIZE = sizeof(double) + sizeof(uint64_t) + sizeof(uint32_t) + 2;
+
+    void Scan(MmsValue* val, size_t index, bool& haveValue, bool& haveQuality, bool& haveTime);
+
+    size_t count_;
+    TimestampMode timestampMode_;
+    uint8_t* buffer_;
+    double* values_;
+    uint64_t* timestamps_;
+    uint32_t* quality_;
+    uint8_t* types_;
+    uint8_t* reasons_;
+};
+
+// Dataset members encoded into one compact little-endian buffer that is handed to JS as an
+// external ArrayBuffer without a copy; mms_payload.js decodes single members on demand into the
+// same values the Objects format produces.
+//
+//   u32 count, u32 flags (bit 0: reasons present), u32 offsets[count + 1],
+//   u8 reasons[count] (if present), encoded members
+//
+// Member i spans offsets[i]..offsets[i + 1]; an empty span is a member not included in a report.
+// A member is a tree of nodes, each an u8 MmsType tag followed by:
+//   ARRAY, STRUCTURE: u32 n, n nodes     BOOLEAN: u8         BIT_STRING: u16 bits, u32 value
+//   INTEGER: i32      FLOAT: f32         VISIBLE_STRING: u32 length, bytes
+//   UTC_TIME: u64 ns, u8 time quality    DATA_ACCESS_ERROR: -  TAG_UNSUPPORTED: u8 MmsType
+class BinaryMmsValues {
+public:
+    static const uint8_t TAG_UNSUPPORTED = 0xFF;
+    static const uint32_t FLAG_REASONS = 1;
+
+    BinaryMmsValues(size_t count, bool withReasons);
+    BinaryMmsValues(const BinaryMmsValues&) = delete;
+    BinaryMmsValues& operator=(const BinaryMmsValues&) = delete;
+
+    // Members must be set in increasing index order; skipped ones stay empty.
+    // member is only read during the call.
+    void Set(size_t index, MmsValue* member);
+    void SetReason(size_t index, uint8_t reason);
+
+    // JS thread only. Hands the buffer over to the returned ArrayBuffer, so call it once.
+    Napi::ArrayBuffer ToNapi(Napi::Env env);
+
+private:
+    template <typename T> void Put(T value);
+    template <typename T> void PutAt(size_t position, T value);
+    void Encode(MmsValue* val);
+    void CloseMembers(size_t upTo);
+
+    size_t count_;
+    size_t next_;             // first member whose start offset is not written yet
+    size_t reasonsOffset_;
+    std::vector<uint8_t> buffer_;
+};
+
+#endif  // MMS_VALUE_CONVERTER_H
@@ -0,0 +1,136 @@
+#include "report_journal.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+constexpr std::chrono::seconds ReportJournal::FLUSH_INTERVAL;
+
+static int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+ReportJournal::ReportJournal(const std::string& path) : path_(path), dirty_(false) {
+    std::ifstream in(path_);
+    if (!in) {
+        printf("ReportJournal: Starting a new journal at %s\n", path_.c_str());
+        return;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string hex;
+        std::string rcbRef;
+        if (!(fields >> hex >> rcbRef) || hex.size() % 2 != 0) {
+            continue;
+        }
+        std::vector<uint8_t> entryId;
+        bool valid = true;
+        for (size_t i = 0; i < hex.size() && valid; i += 2) {
+            int high = HexValue(hex[i]);
+            int low = HexValue(hex[i + 1]);
+            valid = high >= 0 && low >= 0;
+            entryId.push_back(static_cast<uint8_t>(high << 4 | low));
+        }
+        if (valid) {
+            entries_[rcbRef].entryId = entryId;
+        }
+    }
+    printf("ReportJournal: Loaded %zu entries from %s\n", entries_.size(), path_.c_str());
+}
+
+bool ReportJournal::Get(const std::string& rcbRef, std::vector<uint8_t>& entryId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(rcbRef);
+    if (it == entries_.end() || it->second.entryId.empty()) {
+        return false;
+    }
+    entryId = it->second.entryId;
+    return true;
+}
+
+void ReportJournal::Record(const std::string& rcbRef, const uint8_t* entryId, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[rcbRef];
+    if (entry.frozen) {
+        return;
+    }
+    entry.entryId.assign(entryId, entryId + size);
+    dirty_ = true;
+}
+
+void ReportJournal::Freeze(const std::string& rcbRef) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[rcbRef];
+    if (!entry.frozen) {
+        printf("ReportJournal: A report of %s was dropped, keeping its resume point\n", rcbRef.c_str());
+        entry.frozen = true;
+    }
+}
+
+void ReportJournal::Thaw(const std::string& rcbRef) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(rcbRef);
+    if (it != entries_.end()) {
+        it->second.frozen = false;
+    }
+}
+
+bool ReportJournal::Flush() {
+    static const char HEX[] = "0123456789abcdef";
+    std::lock_guard<std::mutex> fileLock(fileMutex_);
+    std::string text;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) {
+            return true;
+        }
+        for (const auto& [rcbRef, entry] : entries_) {
+            if (entry.entryId.empty()) {
+                continue;
+            }
+            for (uint8_t byte : entry.entryId) {
+                text += HEX[byte >> 4];
+                text += HEX[byte & 0xF];
+            }
+            text += ' ';
+            text += rcbRef;
+            text += '\n';
+        }
+        dirty_ = false;
+    }
+
+    // A crash while writing leaves the previous journal intact
+    std::string temporary = path_ + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    bool written = file && fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (file) {
+        written = (fclose(file) == 0) && written;
+    }
+    if (written) {
+        // rename() does not replace an existing file on Windows
+#ifdef _WIN32
+        remove(path_.c_str());
+#endif
+        written = rename(temporary.c_str(), path_.c_str()) == 0;
+    }
+    if (!written) {
+        printf("ReportJournal: Failed to write %s\n", path_.c_str());
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_ = true;
+    }
+    return written;
+}
+
+void ReportJournal::FlushIfDue(std::chrono::steady_clock::time_point now) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now < nextFlush_) {
+            return;
+        }
+        nextFlush_ = now + FLUSH_INTERVAL;
+    }
+    Flush();
+}
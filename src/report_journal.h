@@ -0,0 +1,85 @@
+#ifndef REPORT_JOURNAL_H
+#define REPORT_JOURNAL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Last received EntryID per buffered report control block, kept in a small text file so that
+// reporting can resume after it on reconnect or process restart instead of starting over with a
+// general interrogation. One line per RCB: "<EntryID in hex> <rcbRef>".
+//
+// Record() is called once a report has been handed to JS (see ReportAck) and only touches
+// memory; the file is rewritten (to a temporary file renamed over the old one) by Flush(), at
+// most once per FLUSH_INTERVAL from FlushIfDue(). Delivery is at least once: after a crash the
+// IED replays what was delivered since the last flush.
+class ReportJournal {
+public:
+    static constexpr std::chrono::seconds FLUSH_INTERVAL{1};
+
+    // Loads the journal if the file exists
+    explicit ReportJournal(const std::string& path);
+
+    const std::string& Path() const { return path_; }
+
+    bool Get(const std::string& rcbRef, std::vector<uint8_t>& entryId);
+    // Ignored while the RCB is frozen
+    void Record(const std::string& rcbRef, const uint8_t* entryId, size_t size);
+    // A report of rcbRef was lost before JS saw it: its resume point stays where it is, so a
+    // restart replays the lost report, until Thaw() when reporting on the RCB starts over
+    void Freeze(const std::string& rcbRef);
+    void Thaw(const std::string& rcbRef);
+
+    // Returns false if the file could not be written; the entries stay pending
+    bool Flush();
+    void FlushIfDue(std::chrono::steady_clock::time_point now);
+
+private:
+    std::string path_;
+    std::mutex mutex_;
+    // Held for a whole Flush(): one writer of the temporary file at a time, and a snapshot is
+    // never renamed over a newer one
+    std::mutex fileMutex_;
+    struct Entry {
+        std::vector<uint8_t> entryId;
+        bool frozen = false;
+    };
+    std::map<std::string, Entry> entries_;
+    bool dirty_;
+    std::chrono::steady_clock::time_point nextFlush_;  // guarded by mutex_
+};
+
+// The EntryID of one report on its way to JS. Acknowledge() after the JS callback returned
+// records it; a report dropped on the way (event queue overflow or coalescing, a failed TSFN
+// call) destroys its ack unacknowledged, which freezes the RCB in the journal. Shared by the
+// copies of the event closure that carries it.
+class ReportAck {
+public:
+    ReportAck(ReportJournal* journal, std::string rcbRef, std::vector<uint8_t> entryId)
+        : journal_(journal), rcbRef_(std::move(rcbRef)), entryId_(std::move(entryId)) {}
+    ReportAck(const ReportAck&) = delete;
+    ReportAck& operator=(const ReportAck&) = delete;
+    ~ReportAck() {
+        if (journal_) {
+            journal_->Freeze(rcbRef_);
+        }
+    }
+
+    void Acknowledge() {
+        if (journal_) {
+            journal_->Record(rcbRef_, entryId_.data(), entryId_.size());
+            journal_ = nullptr;
+        }
+    }
+
+private:
+    ReportJournal* journal_;
+    std::string rcbRef_;
+    std::vector<uint8_t> entryId_;
+};
+
+#endif  // REPORT_JOURNAL_H